@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <future>
+#include <numeric>
+#include <vector>
+
+#include "FeatureKernel.hpp"
+#include "OrderBook.hpp"
+
+// 构造指定深度的双边订单簿
+static OrderBook makeBook(int depth) {
+    OrderBook book;
+    for (int level = 0; level < depth; ++level) {
+        book.apply(level, 0, 1, 100.00 - 0.01 * level, (100 + level) * QUANTITY_SCALE);
+        book.apply(level, 0, 0, 100.01 + 0.01 * level, (120 + level) * QUANTITY_SCALE);
+    }
+    return book;
+}
+
+// 旧实现的盘口：数量以 BID64 Decimal 保存
+struct LegacyBook {
+    std::vector<Decimal> bidSizes;
+    std::vector<Decimal> askSizes;
+    double bestBid;
+    double bestAsk;
+};
+
+static LegacyBook makeLegacyBook(int depth) {
+    LegacyBook book{{}, {}, 100.00, 100.01};
+    for (int level = 0; level < depth; ++level) {
+        book.bidSizes.push_back(DecimalFunctions::doubleToDecimal(100 + level));
+        book.askSizes.push_back(DecimalFunctions::doubleToDecimal(120 + level));
+    }
+    return book;
+}
+
+// 旧实现：每个特征一个 std::async，三个盘口特征各自遍历一次订单簿
+static double legacyBuySellRatio(const LegacyBook& book) {
+    Decimal buy = 0, sell = 0;
+    for (Decimal size : book.bidSizes) buy = DecimalFunctions::add(buy, size);
+    for (Decimal size : book.askSizes) sell = DecimalFunctions::add(sell, size);
+    return sell == 0 ? 0.0 : DecimalFunctions::decimalToDouble(DecimalFunctions::div(buy, sell));
+}
+
+static Decimal legacyDepthChange(const LegacyBook& book) {
+    Decimal buy = 0, sell = 0;
+    for (Decimal size : book.bidSizes) buy = DecimalFunctions::add(buy, size);
+    for (Decimal size : book.askSizes) sell = DecimalFunctions::add(sell, size);
+    return DecimalFunctions::sub(buy, sell);
+}
+
+static double legacyImpliedLiquidity(const LegacyBook& book) {
+    double buy = 0.0, sell = 0.0;
+    for (Decimal size : book.bidSizes) buy += DecimalFunctions::decimalToDouble(size);
+    for (Decimal size : book.askSizes) sell += DecimalFunctions::decimalToDouble(size);
+    double spread = book.bestAsk - book.bestBid;
+    return spread <= 0 ? 0.0 : (buy / book.bidSizes.size() + sell / book.askSizes.size()) / spread;
+}
+
+static double historyFeature(const std::deque<double>& history) {
+    return std::accumulate(history.begin(), history.end(), 0.0) / history.size();
+}
+
+// 旧路径：每根 bar 九次线程创建
+static void BM_Features_LegacyAsync(benchmark::State& state) {
+    LegacyBook book = makeLegacyBook(static_cast<int>(state.range(0)));
+    std::deque<double> history(60, 100.0);
+    for (auto _ : state) {
+        auto historyTask = [&history]() { return historyFeature(history); };
+        auto f0 = std::async(std::launch::async, historyTask);
+        auto f1 = std::async(std::launch::async, [&book]() { return legacyBuySellRatio(book); });
+        auto f2 = std::async(std::launch::async, [&book]() { return legacyDepthChange(book); });
+        auto f3 = std::async(std::launch::async, [&book]() { return legacyImpliedLiquidity(book); });
+        auto f4 = std::async(std::launch::async, historyTask);
+        auto f5 = std::async(std::launch::async, historyTask);
+        auto f6 = std::async(std::launch::async, historyTask);
+        auto f7 = std::async(std::launch::async, historyTask);
+        auto f8 = std::async(std::launch::async, historyTask);
+        benchmark::DoNotOptimize(f0.get() + f1.get() + f2.get() + f3.get() + f4.get() + f5.get() + f6.get() + f7.get() + f8.get());
+    }
+}
+BENCHMARK(BM_Features_LegacyAsync)->Arg(10)->Arg(30)->Arg(OrderBook::MAX_DEPTH)->UseRealTime();
+
+// 新路径：单次遍历盘口，全部在调用线程内完成
+static void BM_Features_FusedKernel(benchmark::State& state) {
+    OrderBook book = makeBook(static_cast<int>(state.range(0)));
+    std::deque<double> history(60, 100.0);
+    for (auto _ : state) {
+        BookFeatures features = computeBookFeatures(book);
+        double historyTotal = 0.0;
+        for (int i = 0; i < 6; ++i) historyTotal += historyFeature(history);
+        benchmark::DoNotOptimize(features);
+        benchmark::DoNotOptimize(historyTotal);
+    }
+}
+BENCHMARK(BM_Features_FusedKernel)->Arg(10)->Arg(30)->Arg(OrderBook::MAX_DEPTH)->UseRealTime();
+
+// 增量路径：每次盘口变化后重新计算特征，O(1) 不随深度增长
+static void BM_Features_Running(benchmark::State& state) {
+    OrderBook book = makeBook(static_cast<int>(state.range(0)));
+    int row = 0;
+    for (auto _ : state) {
+        book.apply(row, 1, row & 1, 100.0 + row * 0.01, (row + 1) * QUANTITY_SCALE);
+        row = (row + 1) % static_cast<int>(state.range(0));
+        BookFeatures features = computeBookFeatures(book);
+        benchmark::DoNotOptimize(features);
+    }
+}
+BENCHMARK(BM_Features_Running)->Arg(10)->Arg(30)->Arg(OrderBook::MAX_DEPTH);
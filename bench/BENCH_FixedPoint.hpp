@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FixedPoint.hpp"
+
+// 生成一组随机成交量（整数股）
+static std::vector<Decimal> makeSizes(size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(1, 5000);
+    std::vector<Decimal> sizes;
+    sizes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        sizes.push_back(DecimalFunctions::doubleToDecimal(distribution(generator)));
+    }
+    return sizes;
+}
+
+// 旧路径：用 BID64 软件运算累加成交量
+static void BM_Volume_DecimalAdd(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Decimal total = 0;
+        for (Decimal size : sizes) total = DecimalFunctions::add(total, size);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Volume_DecimalAdd)->Arg(64)->Arg(4096);
+
+// 新路径：到达时解码一次，之后整数累加
+static void BM_Volume_QuantityAdd(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(static_cast<size_t>(state.range(0)));
+    std::vector<Quantity> quantities;
+    for (Decimal size : sizes) quantities.push_back(decimalToQuantity(size));
+    for (auto _ : state) {
+        Quantity total = 0;
+        for (Quantity quantity : quantities) total += quantity;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Volume_QuantityAdd)->Arg(64)->Arg(4096);
+
+// 到达时的转换开销：库函数转 double 与直接按位解码
+static void BM_Convert_DecimalToDouble(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(4096);
+    for (auto _ : state) {
+        double total = 0.0;
+        for (Decimal size : sizes) total += DecimalFunctions::decimalToDouble(size);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_Convert_DecimalToDouble);
+
+static void BM_Convert_DecimalToQuantity(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(4096);
+    for (auto _ : state) {
+        Quantity total = 0;
+        for (Decimal size : sizes) total += decimalToQuantity(size);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_Convert_DecimalToQuantity);
+
+// 写库时的字符串编码：Decimal 与整数数量各自转字符串
+static void BM_Convert_DecimalToString(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(1024);
+    for (auto _ : state) {
+        size_t length = 0;
+        for (Decimal size : sizes) length += DecimalFunctions::decimalToString(size).size();
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetItemsProcessed(state.iterations() * sizes.size());
+}
+BENCHMARK(BM_Convert_DecimalToString);
+
+static void BM_Convert_StringToDecimal(benchmark::State& state) {
+    std::vector<Decimal> sizes = makeSizes(1024);
+    std::vector<std::string> strings;
+    strings.reserve(sizes.size());
+    for (Decimal size : sizes) strings.push_back(DecimalFunctions::decimalToString(size));
+    for (auto _ : state) {
+        Quantity total = 0;
+        for (const std::string& text : strings) total += decimalToQuantity(DecimalFunctions::stringToDecimal(text));
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * strings.size());
+}
+BENCHMARK(BM_Convert_StringToDecimal);
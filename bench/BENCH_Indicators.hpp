@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "BarPayload.hpp"
+#include "Indicators.hpp"
+
+// 随机游走收盘价序列
+static std::vector<double> makeCloses(size_t count) {
+    std::mt19937 generator(7);
+    std::normal_distribution<double> step(0.0, 0.5);
+    std::vector<double> closes;
+    closes.reserve(count);
+    double close = 100.0;
+    for (size_t i = 0; i < count; ++i) {
+        close += step(generator);
+        closes.push_back(close);
+    }
+    return closes;
+}
+
+// 日线：每根 bar 更新全部指标
+static void BM_Indicators_Daily(benchmark::State& state) {
+    std::vector<double> closes = makeCloses(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        DailyIndicators indicators;
+        for (double close : closes) indicators.update(close, 1.0e6);
+        benchmark::DoNotOptimize(indicators.macd.value());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Indicators_Daily)->Arg(252)->Arg(252 * 20);
+
+// 实时：每个分辨率收 bar 时更新 BarSeries
+static void BM_Indicators_RealTime(benchmark::State& state) {
+    std::vector<double> closes = makeCloses(static_cast<size_t>(state.range(0)));
+    std::vector<OhlcvBar> bars(closes.size());
+    for (size_t i = 0; i < closes.size(); ++i) {
+        bars[i].open = bars[i].high = bars[i].low = bars[i].close = closes[i];
+        bars[i].volume = 500 * QUANTITY_SCALE;
+        bars[i].tradeCount = 3;
+    }
+    for (auto _ : state) {
+        BarSeries series;
+        for (const OhlcvBar& bar : bars) series.update(bar);
+        benchmark::DoNotOptimize(series.rsi.value());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Indicators_RealTime)->Arg(4096);
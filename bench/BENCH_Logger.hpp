@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "Logger.hpp"
+
+// 低于日志级别的消息：只走级别判断
+static void BM_Logger_Filtered(benchmark::State& state) {
+    Logger logger("/dev/null", LogLevel::INFO);
+    const std::string message = "Received L2 update for AAPL";
+    for (auto _ : state) {
+        STX_LOGD(&logger, message);
+    }
+}
+BENCHMARK(BM_Logger_Filtered);
+
+// 实际写出的消息：时间戳格式化、加锁与写文件
+static void BM_Logger_Written(benchmark::State& state) {
+    Logger logger("/dev/null", LogLevel::INFO);
+    const std::string message = "Received L2 update for AAPL";
+    for (auto _ : state) {
+        STX_LOGI(&logger, message);
+    }
+}
+BENCHMARK(BM_Logger_Written);
+
+// 多线程争用同一个 Logger
+static void BM_Logger_Contended(benchmark::State& state) {
+    static Logger logger("/dev/null", LogLevel::INFO);
+    const std::string message = "Received L2 update for AAPL";
+    for (auto _ : state) {
+        STX_LOGI(&logger, message);
+    }
+}
+BENCHMARK(BM_Logger_Contended)->Threads(1)->Threads(4);
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "BarPayload.hpp"
+#include "SharedMemoryBars.hpp"
+
+// 构造一根带成交的 bar
+static OhlcvBar makeBar(double close) {
+    BarBuilder builder;
+    builder.onPrice(close - 0.05);
+    builder.onSize(300 * QUANTITY_SCALE);
+    builder.onPrice(close);
+    builder.onSize(200 * QUANTITY_SCALE);
+    return builder.finish();
+}
+
+// 预热指标窗口后的 BarSeries
+static BarSeries makeSeries() {
+    BarSeries series;
+    for (size_t i = 0; i < BAR_INDICATOR_WINDOW; ++i) series.update(makeBar(100.0 + 0.01 * i));
+    return series;
+}
+
+// 盘口静置一分钟后的时间加权深度
+static DepthHistogram makeDepth(const OrderBook& book) {
+    DepthHistogram histogram;
+    for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+        for (int level = 0; level < book.depth(side); ++level) {
+            histogram.add(side, histogram.ladder().bucketOf(book.price(side, level)), quantityToDouble(book.size(side, level)) * 60.0);
+        }
+    }
+    histogram.seconds = 60.0;
+    return histogram;
+}
+
+// realtime_depth 行：按价格阶梯逐桶输出，不扫描事件
+static void BM_Payload_DepthRows(benchmark::State& state) {
+    DepthHistogram histogram = makeDepth(makeBook(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(depthRows(histogram));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Payload_DepthRows)->RangeMultiplier(4)->Range(4, OrderBook::MAX_DEPTH);
+
+// 时间加权深度：每条 updateMktDepth 的增量记账
+static void BM_Payload_DepthUpdate(benchmark::State& state) {
+    OrderBook book = makeBook(static_cast<int>(state.range(0)));
+    TimeWeightedDepth depth;
+    int64_t now = 1;
+    int row = 0;
+    for (auto _ : state) {
+        now += 1000000;
+        depth.apply(book, row, 1, row & 1, 100.0 + 0.01 * row, (row + 1) * QUANTITY_SCALE, now);
+        row = (row + 1) % static_cast<int>(state.range(0));
+    }
+}
+BENCHMARK(BM_Payload_DepthUpdate)->Arg(10)->Arg(OrderBook::MAX_DEPTH);
+
+// realtime_bars 行：OHLCV 与特征列
+static void BM_Payload_BarRow(benchmark::State& state) {
+    BarSeries series = makeSeries();
+    BookFeatures features = computeBookFeatures(makeBook(static_cast<int>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(barRow(series, &features));
+    }
+}
+BENCHMARK(BM_Payload_BarRow)->Arg(10);
+
+// 一根 bar 写库所需的全部行（bar 行与深度行）
+static void BM_Payload_Row(benchmark::State& state) {
+    BarSeries series = makeSeries();
+    OrderBook book = makeBook(static_cast<int>(state.range(0)));
+    BookFeatures features = computeBookFeatures(book);
+    DepthHistogram histogram = makeDepth(book);
+    for (auto _ : state) {
+        RealTimeBar row = barRow(series, &features);
+        row.depth = depthRows(histogram);
+        benchmark::DoNotOptimize(row.depth.data());
+    }
+}
+BENCHMARK(BM_Payload_Row)->Arg(10)->Arg(OrderBook::MAX_DEPTH);
+
+// 共享内存发布（取代原 createCombinedJson 的拼接 JSON）
+static void BM_Payload_SharedMemoryPublish(benchmark::State& state) {
+    const uint32_t ringCapacity = static_cast<uint32_t>(state.range(0));
+    std::vector<SharedMemoryChannelSpec> channels{{"AAPL", 5}};
+    const size_t size = SharedMemoryBarWriter::requiredSize(channels.size(), ringCapacity);
+    std::vector<uint64_t> region(size / sizeof(uint64_t) + 1);
+    SharedMemoryBarWriter writer(region.data(), size, channels, ringCapacity);
+
+    SharedMemoryBarRecord record{};
+    record.close = 100.0;
+    for (auto _ : state) {
+        ++record.timestamp;
+        writer.publish(0, record);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Payload_SharedMemoryPublish)->Arg(256);
@@ -0,0 +1,9 @@
+#include <benchmark/benchmark.h>
+
+#include "BENCH_FeatureKernel.hpp"
+#include "BENCH_FixedPoint.hpp"
+#include "BENCH_Payload.hpp"
+#include "BENCH_Indicators.hpp"
+#include "BENCH_Logger.hpp"
+
+BENCHMARK_MAIN();
@@ -0,0 +1,318 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "EDecoder.h"
+#include "RealTimeData.hpp"
+#include "PipelineHarness.hpp"
+
+namespace {
+
+// Trade prices walk 100.00, 100.01, ... and wrap after TRADE_SLOTS trades, so the
+// close of a published bar tells which trade it ended on.
+constexpr double TRADE_BASE_PRICE = 100.0;
+constexpr double TRADE_TICK = 0.01;
+constexpr uint32_t TRADE_SLOTS = 10000;
+constexpr double BOOK_MID = 100.0;
+
+std::string formatPrice(double price) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << price;
+    return oss.str();
+}
+
+// Text COPY rows of one bar: the realtime_bars row, then one realtime_depth row per bucket.
+std::string copyRows(const RealTimeBar& bar) {
+    std::ostringstream oss;
+    oss << std::setprecision(17);
+    auto field = [&oss](const auto& value) { oss << '\t' << value; };
+    auto optional = [&oss](const auto& value) {
+        if (value) oss << '\t' << *value; else oss << "\t\\N";
+    };
+    oss << bar.datetime << '\t' << bar.symbol << '\t' << bar.resolution;
+    for (double value : {bar.open, bar.high, bar.low, bar.close, bar.volume}) field(value);
+    field(bar.tradeCount);
+    for (double value : {bar.weightedAvgPrice, bar.priceMomentum, bar.tradeDensity, bar.rsi, bar.macd, bar.vwap}) field(value);
+    for (const auto& value : {bar.buySellRatio, bar.depthChange, bar.impliedLiquidity}) optional(value);
+    optional(bar.tickTrades);
+    optional(bar.tickQuotes);
+    for (const auto& value : {bar.spread, bar.microprice, bar.quoteImbalance, bar.orderFlowImbalance, bar.signedVolume}) optional(value);
+    oss << '\n';
+    for (const DepthLevel& level : bar.depth) {
+        oss << bar.datetime << '\t' << bar.symbol << '\t' << bar.resolution << '\t'
+            << level.price << '\t' << level.bidSize << '\t' << level.askSize << '\n';
+    }
+    return oss.str();
+}
+
+inline int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t epochNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+nlohmann::json summaryJson(const std::map<int, LatencySummary>& summaries) {
+    nlohmann::json result = nlohmann::json::object();
+    for (const auto& [resolution, summary] : summaries) {
+        result[resolutionLabel(resolution)] = {
+            {"samples", summary.samples},
+            {"p50_us", summary.p50Us},
+            {"p99_us", summary.p99Us},
+            {"p999_us", summary.p999Us},
+            {"max_us", summary.maxUs}
+        };
+    }
+    return result;
+}
+
+} // namespace
+
+LatencySummary LatencySummary::fromSamples(std::vector<int64_t> samplesNs) {
+    LatencySummary summary;
+    summary.samples = samplesNs.size();
+    if (samplesNs.empty()) return summary;
+
+    std::sort(samplesNs.begin(), samplesNs.end());
+    auto percentile = [&samplesNs](double fraction) {
+        size_t index = static_cast<size_t>(std::ceil(fraction * samplesNs.size()));
+        return samplesNs[std::min(samplesNs.size() - 1, index == 0 ? 0 : index - 1)] / 1000.0;
+    };
+    summary.p50Us = percentile(0.50);
+    summary.p99Us = percentile(0.99);
+    summary.p999Us = percentile(0.999);
+    summary.maxUs = samplesNs.back() / 1000.0;
+    return summary;
+}
+
+nlohmann::json PipelineReport::toJson(const PipelineOptions& options) const {
+    return {
+        {"options", {
+            {"symbols", options.symbols},
+            {"messages", options.messages},
+            {"seconds", options.seconds},
+            {"rate", options.messagesPerSecond},
+            {"l2_share", options.l2Share},
+            {"depth", options.depth},
+            {"shards", options.shards},
+            {"seed", options.seed}
+        }},
+        {"messages", messages},
+        {"feed_seconds", feedSeconds},
+        {"messages_per_second", messagesPerSecond},
+        {"dropped", dropped},
+        {"bars", bars},
+        {"rows", rows},
+        {"row_bytes", rowBytes},
+        {"tick_to_publish", summaryJson(tickToPublish)},
+        {"boundary_to_publish", summaryJson(boundaryToPublish)}
+    };
+}
+
+PipelineHarness::PipelineHarness(const PipelineOptions& _options)
+    : options(_options), arrivals(new std::atomic<int64_t>[static_cast<size_t>(std::max(_options.symbols, 0)) * TRADE_SLOTS]()) {
+    if (options.symbols <= 0 || options.messages == 0 || options.seconds < 0.0 || options.messagesPerSecond < 0.0 ||
+        options.l2Share < 0.0 || options.l2Share > 1.0 || options.depth <= 0 || options.depth > OrderBook::MAX_DEPTH) {
+        throw std::invalid_argument("Invalid pipeline benchmark options");
+    }
+    buildMessages();
+}
+
+void PipelineHarness::appendFrame(const std::vector<std::string>& fields, int32_t tradeSymbol, uint32_t tradeSlot) {
+    Message message{static_cast<uint32_t>(data.size()), 0, tradeSymbol, tradeSlot};
+    for (const auto& field : fields) {
+        data.insert(data.end(), field.begin(), field.end());
+        data.push_back('\0');
+    }
+    message.size = static_cast<uint32_t>(data.size() - message.begin);
+    messages.push_back(message);
+}
+
+void PipelineHarness::buildMessages() {
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> symbol(0, options.symbols - 1);
+    std::uniform_int_distribution<int> size(1, 1000);
+    std::uniform_int_distribution<int> position(0, options.depth - 1);
+    std::vector<uint32_t> tradeCounts(options.symbols, 0);
+
+    // Full books first, the way TWS answers a fresh reqMktDepth; bars are only published over a non-empty book.
+    for (int i = 0; i < options.symbols; ++i) {
+        std::string tickerId = std::to_string(RealTimeData::tickerIdFor(i, RealTimeData::L2_STREAM));
+        for (int side = 0; side < 2; ++side) {
+            for (int row = 0; row < options.depth; ++row) {
+                double price = BOOK_MID + (side == 0 ? 1 : -1) * (row + 1) * TRADE_TICK;
+                appendFrame({std::to_string(MARKET_DEPTH), "1", tickerId, std::to_string(row), "0",
+                             std::to_string(side), formatPrice(price), std::to_string(size(rng))});
+            }
+        }
+    }
+    warmupMessages = messages.size();
+
+    for (uint64_t i = 0; i < options.messages; ++i) {
+        int index = symbol(rng);
+        if (unit(rng) < options.l2Share) {
+            int row = position(rng);
+            int side = unit(rng) < 0.5 ? 0 : 1;
+            double price = BOOK_MID + (side == 0 ? 1 : -1) * (row + 1) * TRADE_TICK;
+            appendFrame({std::to_string(MARKET_DEPTH), "1", std::to_string(RealTimeData::tickerIdFor(index, RealTimeData::L2_STREAM)),
+                         std::to_string(row), "1", std::to_string(side), formatPrice(price), std::to_string(size(rng))});
+            continue;
+        }
+
+        std::string tickerId = std::to_string(RealTimeData::tickerIdFor(index, RealTimeData::L1_STREAM));
+        double draw = unit(rng);
+        if (draw < 0.5) {
+            uint32_t slot = tradeCounts[index]++ % TRADE_SLOTS;
+            appendFrame({std::to_string(TICK_PRICE), "6", tickerId, std::to_string(LAST),
+                         formatPrice(TRADE_BASE_PRICE + slot * TRADE_TICK), std::to_string(size(rng)), "0"}, index, slot);
+        } else {
+            TickType tickType = draw < 0.75 ? BID : ASK;
+            double price = BOOK_MID + (tickType == BID ? -TRADE_TICK : TRADE_TICK);
+            appendFrame({std::to_string(TICK_PRICE), "6", tickerId, std::to_string(tickType),
+                         formatPrice(price), std::to_string(size(rng)), "0"});
+        }
+    }
+}
+
+void PipelineHarness::onBarPublished(size_t symbolIndex, int resolution, int64_t boundary, const OhlcvBar& bar) {
+    const int64_t publishedAt = steadyNs();
+    const int64_t boundaryLag = epochNs() - boundary * 1000000000LL;
+
+    int64_t tickLatency = -1;
+    long slot = std::lround((bar.close - TRADE_BASE_PRICE) / TRADE_TICK);
+    if (slot >= 0 && slot < static_cast<long>(TRADE_SLOTS)) {
+        int64_t arrival = arrivals[symbolIndex * TRADE_SLOTS + slot].load(std::memory_order_relaxed);
+        if (arrival > 0) tickLatency = publishedAt - arrival;
+    }
+
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    boundarySamples[resolution].emplace_back(boundary, boundaryLag);
+    if (tickLatency >= 0) tickSamples[resolution].emplace_back(boundary, tickLatency);
+}
+
+PipelineReport PipelineHarness::run() {
+    auto logger = std::make_shared<Logger>(options.logFile, LogLevel::WARNING);
+
+    RealTimeConfig config;
+    config.symbols.clear();
+    for (int i = 0; i < options.symbols; ++i) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "SYM%03d", i);
+        config.symbols.push_back({name, "SMART"});
+    }
+    config.shards = options.shards;
+    config.workers = options.shards;
+
+    // In-memory store: rows are serialized as they would be for the COPY, then kept.
+    std::vector<std::string> store;
+    uint64_t rowBytes = 0;
+
+    RealTimeData realtime(logger, nullptr, config);
+    realtime.setRowSink([&store, &rowBytes](const RealTimeBar& bar) {
+        store.push_back(copyRows(bar));
+        rowBytes += store.back().size();
+        return true;
+    });
+    realtime.setPublishHook([this](size_t symbolIndex, int resolution, int64_t boundary, const OhlcvBar& bar) {
+        onBarPublished(symbolIndex, resolution, boundary, bar);
+    });
+
+    if (!realtime.startOffline()) {
+        throw std::runtime_error("Failed to start the real-time pipeline, see " + options.logFile);
+    }
+
+    EDecoder decoder(options.serverVersion, &realtime);
+    auto feed = [this, &decoder](const Message& message) {
+        const char* begin = data.data() + message.begin;
+        decoder.parseAndProcessMsg(begin, begin + message.size);
+    };
+
+    for (size_t i = 0; i < warmupMessages; ++i) feed(messages[i]);
+
+    const auto feedStart = std::chrono::steady_clock::now();
+    const auto feedDeadline = feedStart + std::chrono::nanoseconds(static_cast<int64_t>(options.seconds * 1e9));
+    uint64_t fed = 0;
+    do {
+        for (size_t i = warmupMessages; i < messages.size(); ++i) {
+            const Message& message = messages[i];
+            if (options.messagesPerSecond > 0.0 && fed % 64 == 0) {
+                std::this_thread::sleep_until(feedStart + std::chrono::nanoseconds(static_cast<int64_t>(fed * 1e9 / options.messagesPerSecond)));
+            }
+            if (message.tradeSymbol >= 0) {
+                arrivals[static_cast<size_t>(message.tradeSymbol) * TRADE_SLOTS + message.tradeSlot].store(steadyNs(), std::memory_order_relaxed);
+            }
+            feed(message);
+            if (++fed % 1024 == 0 && options.seconds > 0.0 && std::chrono::steady_clock::now() >= feedDeadline) break;
+        }
+    } while (std::chrono::steady_clock::now() < feedDeadline);
+    const auto feedEnd = std::chrono::steady_clock::now();
+    const int64_t feedEndEpochSecond = epochNs() / 1000000000LL;
+
+    // Let the shards drain the rings, then give them one more second boundary to close the last bars.
+    auto pending = [&realtime]() {
+        size_t total = 0;
+        for (const auto& stats : realtime.getRingStats()) total += stats.l1Occupancy + stats.l2Occupancy + stats.tickOccupancy;
+        return total;
+    };
+    while (pending() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    PipelineReport report;
+    for (const auto& stats : realtime.getRingStats()) report.dropped += stats.l1Dropped + stats.l2Dropped + stats.tickDropped;
+    realtime.stop();
+
+    report.messages = fed;
+    report.feedSeconds = std::chrono::duration<double>(feedEnd - feedStart).count();
+    report.messagesPerSecond = report.feedSeconds > 0.0 ? report.messages / report.feedSeconds : 0.0;
+    report.rows = store.size();
+    report.rowBytes = rowBytes;
+
+    auto summarize = [feedEndEpochSecond](const std::vector<std::pair<int64_t, int64_t>>& samples) {
+        std::vector<int64_t> latencies;
+        latencies.reserve(samples.size());
+        for (const auto& [boundary, latency] : samples) {
+            if (boundary <= feedEndEpochSecond) latencies.push_back(latency);
+        }
+        return LatencySummary::fromSamples(std::move(latencies));
+    };
+
+    std::lock_guard<std::mutex> lock(samplesMutex);
+    for (const auto& [resolution, samples] : boundarySamples) {
+        report.bars += samples.size();
+        report.boundaryToPublish[resolution] = summarize(samples);
+    }
+    for (const auto& [resolution, samples] : tickSamples) {
+        report.tickToPublish[resolution] = summarize(samples);
+    }
+    return report;
+}
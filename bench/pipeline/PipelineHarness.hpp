@@ -0,0 +1,113 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#ifndef PIPELINE_HARNESS_H
+#define PIPELINE_HARNESS_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "BarBuilder.hpp"
+
+// End-to-end load of the real-time ingestion path:
+//   EDecoder -> RealTimeData callbacks -> rings -> shard aggregation -> shared memory -> database writer queue.
+// A fixed synthetic message sequence is decoded on the calling thread, standing
+// in for the EReader thread; the database writer hands its rows to an in-memory
+// store instead of TimescaleDB.
+struct PipelineOptions {
+    int symbols = 10;
+    uint64_t messages = 1000000;      // length of the synthetic sequence
+    double seconds = 5.0;             // the sequence is fed in a loop for this long; 0 feeds it once
+    double messagesPerSecond = 0.0;   // 0 feeds as fast as the decoder allows
+    double l2Share = 0.8;             // fraction of the messages that are depth updates
+    int depth = 10;                   // rows per book side
+    size_t shards = 1;
+    int serverVersion = 176;
+    uint32_t seed = 42;
+    std::string logFile = "PipelineBench.log";
+    std::string output;               // JSON report path; empty prints the summary only
+};
+
+struct LatencySummary {
+    size_t samples = 0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+
+    static LatencySummary fromSamples(std::vector<int64_t> samplesNs);
+};
+
+struct PipelineReport {
+    uint64_t messages = 0;
+    double feedSeconds = 0.0;
+    double messagesPerSecond = 0.0;
+    uint64_t dropped = 0;                        // ring overflows; a rate only counts as sustained at zero
+    size_t bars = 0;
+    size_t rows = 0;
+    uint64_t rowBytes = 0;
+    std::map<int, LatencySummary> tickToPublish;     // last trade of the bar -> shared memory, per resolution
+    std::map<int, LatencySummary> boundaryToPublish; // bar close boundary -> shared memory, per resolution
+
+    nlohmann::json toJson(const PipelineOptions& options) const;
+};
+
+class PipelineHarness {
+public:
+    explicit PipelineHarness(const PipelineOptions& options);
+
+    PipelineReport run();
+
+private:
+    struct Message {
+        uint32_t begin;
+        uint32_t size;
+        int32_t tradeSymbol;   // symbol of a LAST trade, -1 for every other message
+        uint32_t tradeSlot;
+    };
+
+    void buildMessages();
+    void appendFrame(const std::vector<std::string>& fields, int32_t tradeSymbol = -1, uint32_t tradeSlot = 0);
+    void onBarPublished(size_t symbolIndex, int resolution, int64_t boundary, const OhlcvBar& bar);
+
+    PipelineOptions options;
+    std::vector<char> data;
+    std::vector<Message> messages;
+    size_t warmupMessages = 0;   // initial books, fed before the clock starts
+
+    // Steady-clock arrival of the latest trade per (symbol, slot); the slot is encoded in the trade price.
+    std::unique_ptr<std::atomic<int64_t>[]> arrivals;
+
+    // (bar boundary, latency ns) per resolution. Bars closing after the feed
+    // stopped are left out: their last trade waited on an idle stream.
+    std::mutex samplesMutex;
+    std::map<int, std::vector<std::pair<int64_t, int64_t>>> tickSamples;
+    std::map<int, std::vector<std::pair<int64_t, int64_t>>> boundarySamples;
+};
+
+#endif // PIPELINE_HARNESS_H
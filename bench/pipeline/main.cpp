@@ -0,0 +1,103 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "BarEngine.hpp"
+#include "PipelineHarness.hpp"
+
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--symbols 10] [--messages 1000000] [--seconds 5] [--rate 0] [--l2-share 0.8] [--depth 10]"
+              << " [--shards 1] [--seed 42] [--log PipelineBench.log] [--output report.json]" << std::endl;
+}
+
+static void printLatencies(const std::string& title, const std::map<int, LatencySummary>& summaries) {
+    std::cout << title << std::endl;
+    std::cout << "  " << std::left << std::setw(8) << "bar" << std::right << std::setw(10) << "samples"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us" << std::setw(12) << "max us" << std::endl;
+    for (const auto& [resolution, summary] : summaries) {
+        std::cout << "  " << std::left << std::setw(8) << resolutionLabel(resolution) << std::right << std::setw(10) << summary.samples
+                  << std::fixed << std::setprecision(1) << std::setw(12) << summary.p50Us << std::setw(12) << summary.p99Us
+                  << std::setw(12) << summary.p999Us << std::setw(12) << summary.maxUs << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    PipelineOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--symbols") options.symbols = std::stoi(value);
+            else if (arg == "--messages") options.messages = std::stoull(value);
+            else if (arg == "--seconds") options.seconds = std::stod(value);
+            else if (arg == "--rate") options.messagesPerSecond = std::stod(value);
+            else if (arg == "--l2-share") options.l2Share = std::stod(value);
+            else if (arg == "--depth") options.depth = std::stoi(value);
+            else if (arg == "--shards") options.shards = std::stoul(value);
+            else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--log") options.logFile = value;
+            else if (arg == "--output") options.output = value;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        PipelineHarness harness(options);
+        PipelineReport report = harness.run();
+
+        std::cout << std::fixed << std::setprecision(0)
+                  << "messages: " << report.messages << " in " << std::setprecision(3) << report.feedSeconds << " s, "
+                  << std::setprecision(0) << report.messagesPerSecond << " msg/s"
+                  << (report.dropped > 0 ? " (NOT sustained: " + std::to_string(report.dropped) + " dropped by the rings)" : "") << std::endl;
+        std::cout << "bars published: " << report.bars << ", rows stored: " << report.rows << " (" << report.rowBytes << " bytes)" << std::endl;
+        printLatencies("last trade -> shared memory", report.tickToPublish);
+        printLatencies("bar boundary -> shared memory", report.boundaryToPublish);
+
+        if (!options.output.empty()) {
+            std::ofstream out(options.output);
+            out << report.toJson(options).dump(2) << std::endl;
+            if (!out) {
+                std::cerr << "Failed to write " << options.output << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
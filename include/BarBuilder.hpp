@@ -0,0 +1,103 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef BAR_BUILDER_H
+#define BAR_BUILDER_H
+
+#include <cstdint>
+
+#include "FixedPoint.hpp"
+
+struct OhlcvBar {
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    Quantity volume = 0;
+    double priceVolume = 0.0;
+    double vwapVolume = 0.0;
+    uint64_t tradeCount = 0;
+
+    inline double vwap() const { return vwapVolume == 0.0 ? close : priceVolume / vwapVolume; }
+};
+
+// Streaming OHLCV builder. TWS delivers a trade as a LAST price followed by a
+// LAST_SIZE, so prices drive open/high/low/close and sizes drive volume, VWAP
+// and the trade count. Every update is O(1); finish() hands the bar over
+// without looking at past ticks.
+class BarBuilder {
+public:
+    inline void onPrice(double price) {
+        if (!hasPrice) {
+            bar.open = bar.high = bar.low = price;
+            hasPrice = true;
+        } else {
+            if (price > bar.high) bar.high = price;
+            if (price < bar.low) bar.low = price;
+        }
+        bar.close = price;
+        lastPrice = price;
+    }
+
+    inline void onSize(Quantity size) {
+        if (size == UNSET_QUANTITY) return;
+        bar.volume += size;
+        ++bar.tradeCount;
+        if (lastPrice > 0.0) {
+            double quantity = quantityToDouble(size);
+            bar.priceVolume += lastPrice * quantity;
+            bar.vwapVolume += quantity;
+        }
+    }
+
+    // Folds a finished finer-grained bar into this one.
+    inline void onBar(const OhlcvBar& child) {
+        if (!hasPrice) {
+            bar.open = child.open;
+            bar.high = child.high;
+            bar.low = child.low;
+            hasPrice = true;
+        } else {
+            if (child.high > bar.high) bar.high = child.high;
+            if (child.low < bar.low) bar.low = child.low;
+        }
+        bar.close = child.close;
+        bar.volume += child.volume;
+        bar.priceVolume += child.priceVolume;
+        bar.vwapVolume += child.vwapVolume;
+        bar.tradeCount += child.tradeCount;
+        lastPrice = child.close;
+    }
+
+    // True once the bar has both a price and at least one trade size.
+    inline bool hasTrades() const { return hasPrice && bar.tradeCount > 0; }
+    inline const OhlcvBar& current() const { return bar; }
+
+    OhlcvBar finish();
+    void reset();
+
+private:
+    OhlcvBar bar;
+    bool hasPrice = false;
+    double lastPrice = 0.0;   // carried across bars so a leading size still has a price
+};
+
+#endif // BAR_BUILDER_H
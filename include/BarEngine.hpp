@@ -0,0 +1,87 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef BAR_ENGINE_H
+#define BAR_ENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BarBuilder.hpp"
+
+// Hierarchical bar engine. Ticks only feed the finest resolution; every coarser
+// resolution is built by folding in the finished bars of the one below it, so a
+// tick is touched once no matter how many resolutions are configured.
+// Resolutions are in seconds, strictly ascending, and each must be a multiple
+// of the previous one (e.g. 1, 5, 60, 300, 900).
+class BarEngine {
+public:
+    explicit BarEngine(const std::vector<int>& resolutionSeconds);
+
+    inline void onPrice(double price) { builders.front().onPrice(price); }
+    inline void onSize(Quantity size) { builders.front().onSize(size); }
+
+    // Closes every bar whose interval ended at or before `epochSecond` and calls
+    // onBarClosed(resolutionIndex, boundaryEpochSecond, bar) for each bar that saw
+    // trades. The first call only aligns the engine to the clock.
+    template <typename Callback>
+    void advance(int64_t epochSecond, Callback&& onBarClosed) {
+        const int64_t finest = resolutions.front();
+        if (lastBoundary == 0) {
+            lastBoundary = epochSecond - epochSecond % finest;
+            return;
+        }
+        for (int64_t boundary = lastBoundary + finest; boundary <= epochSecond; boundary += finest) {
+            closeLevel(0, boundary, onBarClosed);
+            lastBoundary = boundary;
+        }
+    }
+
+    // The finest bar still open; its trades are not yet in any coarser one.
+    inline const OhlcvBar& openBar() const { return builders.front().current(); }
+    inline size_t resolutionCount() const { return resolutions.size(); }
+    inline int resolution(size_t index) const { return resolutions[index]; }
+
+private:
+    template <typename Callback>
+    void closeLevel(size_t level, int64_t boundary, Callback& onBarClosed) {
+        if (builders[level].hasTrades()) {
+            OhlcvBar bar = builders[level].finish();
+            if (level + 1 < builders.size()) builders[level + 1].onBar(bar);
+            onBarClosed(level, boundary, bar);
+        } else {
+            builders[level].reset();
+        }
+        if (level + 1 < builders.size() && boundary % resolutions[level + 1] == 0) {
+            closeLevel(level + 1, boundary, onBarClosed);
+        }
+    }
+
+    std::vector<int> resolutions;
+    std::vector<BarBuilder> builders;
+    int64_t lastBoundary = 0;
+};
+
+// "1s", "5s", "1m", "15m", "1h" ...
+std::string resolutionLabel(int seconds);
+
+#endif // BAR_ENGINE_H
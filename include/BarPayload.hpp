@@ -0,0 +1,93 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef BAR_PAYLOAD_H
+#define BAR_PAYLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BarBuilder.hpp"
+#include "FeatureKernel.hpp"
+#include "Indicators.hpp"
+#include "OrderBook.hpp"
+#include "RealTimeBar.hpp"
+#include "TimeWeightedDepth.hpp"
+
+constexpr size_t BAR_INDICATOR_WINDOW = 60;   // bars behind the rolling VWAP, momentum and trade density
+
+// Last finished bar and the streaming indicators of one resolution; the
+// indicator features of a bar are computed over its own resolution.
+struct BarSeries {
+    int seconds = 0;
+    bool persist = false;
+    OhlcvBar lastBar;
+    RsiIndicator rsi{14};
+    MacdIndicator macd{12, 26, 9};
+    VwapIndicator vwap{BAR_INDICATOR_WINDOW};
+    MomentumIndicator momentum{BAR_INDICATOR_WINDOW - 1};
+    SmaIndicator tradeDensity{BAR_INDICATOR_WINDOW};
+    TickFeatures ticks;              // tick-by-tick activity of the open bar
+    MicrostructureFeatures micro;    // top-of-book spread, imbalance and signed flow of the open bar
+    DepthHistogram depth;            // time-weighted resting size per price over the open bar
+    int64_t openBarStart = 0;        // epoch second the accumulators started at; 0 before the first cycle
+
+    inline void update(const OhlcvBar& bar) {
+        const double volume = quantityToDouble(bar.volume);
+        lastBar = bar;
+        rsi.update(bar.close);
+        macd.update(bar.close);
+        vwap.update(bar.close, volume);
+        momentum.update(bar.close);
+        tradeDensity.update(volume);
+    }
+
+    // Restarts the per-bar accumulators if a bar of this resolution ended since
+    // the last call. Compares bar starts rather than testing `epochSecond` for a
+    // boundary, so a late cycle that skips the boundary second still resets.
+    inline void rollAccumulators(int64_t epochSecond) {
+        const int64_t barStart = epochSecond - epochSecond % seconds;
+        if (barStart == openBarStart) return;
+        if (openBarStart != 0) {
+            ticks.reset();
+            micro.reset();
+            depth.clear();
+        }
+        openBarStart = barStart;
+    }
+};
+
+// The realtime_bars columns of the series' last bar: OHLCV, book and indicator
+// features; `book` is null for a symbol without an L2 book, whose book columns
+// stay empty. Symbol, resolution, datetime and depth are left to the caller.
+RealTimeBar barRow(const BarSeries& series, const BookFeatures* book);
+// The realtime_depth rows of a bar: one per price-ladder bucket the book rested
+// in during the bar, each holding the average size that rested there, so a
+// level that sat all bar outweighs one that flickered. Buckets with nothing
+// resting have no row. Bucket prices are fixed by the ladder, not by the bar.
+std::vector<DepthLevel> depthRows(const DepthHistogram& depth);
+// "YYYY-MM-DD HH:MM:SS+00": the instant of a bar boundary, independent of the
+// local and database time zones, so repeated local hours stay distinct rows.
+std::string utcTimestamp(int64_t epochSecond);
+
+#endif // BAR_PAYLOAD_H
@@ -0,0 +1,102 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+// Time source of the real-time pipeline. Every thread that schedules work on
+// the clock brackets its loop with attach()/detach() and sleeps through
+// waitUntil(), so a simulated clock knows when all of them are idle.
+class Clock {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    virtual TimePoint now() const = 0;
+
+    // Sleeps until now() reaches `deadline`, `realTimeout` of wall time passes
+    // or the clock is interrupted. Returns true when the deadline was reached.
+    virtual bool waitUntil(TimePoint deadline, std::chrono::nanoseconds realTimeout) = 0;
+    // Makes every current and future waitUntil() return at once until resume(); used on shutdown.
+    virtual void interrupt() = 0;
+    virtual void resume() = 0;
+
+    virtual void attach() {}
+    virtual void detach() {}
+};
+
+// Wall time.
+class SystemClock : public Clock {
+public:
+    TimePoint now() const override;
+    bool waitUntil(TimePoint deadline, std::chrono::nanoseconds realTimeout) override;
+    void interrupt() override;
+    void resume() override;
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool interrupted = false;
+};
+
+// Time that only moves when advanceTo() is called: by a test, a benchmark, or
+// TwsJournalReplayer stamping each chunk with its recorded time.
+// advanceTo() waits until every attached thread is back in waitUntil() with a
+// deadline past the new time, so the work due at each instant is finished
+// before the caller feeds data stamped after it. That keeps bar boundaries
+// exact however fast the data is replayed.
+class SimulatedClock : public Clock {
+public:
+    explicit SimulatedClock(TimePoint start);
+
+    TimePoint now() const override;
+    bool waitUntil(TimePoint deadline, std::chrono::nanoseconds realTimeout) override;
+    void interrupt() override;
+    void resume() override;
+    void attach() override;
+    void detach() override;
+
+    // Moves time forward (never backward) and returns once the attached threads are idle again.
+    void advanceTo(TimePoint time);
+    inline void advanceBy(std::chrono::nanoseconds duration) { advanceTo(now() + duration); }
+
+private:
+    bool idle() const;
+
+    std::atomic<int64_t> nowNs;
+    mutable std::mutex mutex;
+    std::condition_variable waiterCV;    // waiters wait for time to move
+    std::condition_variable advanceCV;   // advanceTo waits for waiters to settle
+    std::multiset<int64_t> deadlines;    // one per thread inside waitUntil
+    size_t attached = 0;
+    bool interrupted = false;
+};
+
+#endif // CLOCK_H
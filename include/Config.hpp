@@ -26,6 +26,11 @@
 #include <boost/property_tree/ini_parser.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
 
 #include "Logger.hpp"
 
@@ -35,9 +40,73 @@ struct DBConfig {
     std::string dbname;
     std::string user;
     std::string password;
+    size_t poolSize = 4;   // connections shared by the real-time writer, the daily writer and the readers
 };
 
-DBConfig loadConfig(const std::string& configFilePath, const std::shared_ptr<Logger>& logger) {
+struct SymbolConfig {
+    std::string symbol;
+    std::string exchange;
+};
+
+struct RealTimeConfig {
+    std::vector<SymbolConfig> symbols{{"SPY", "ARCA"}};
+    size_t shards = 1;
+    size_t workers = 1;                                         // aggregation threads; ignored when workerCpus is set
+    std::vector<int> workerCpus;                                // pins one aggregation thread to each listed CPU
+    std::vector<int> barResolutions{1, 5, 60, 300, 900};        // seconds, finest first
+    std::vector<int> databaseResolutions{1, 5, 60, 300, 900};   // subset of barResolutions persisted to the database
+    uint32_t sharedMemoryHistory = 256;                         // bars kept per symbol and resolution in shared memory
+    bool tickByTick = false;                                    // reqTickByTickData trades and quotes instead of reqMktData L1
+    int bookSnapshotMs = -1;                                    // book feature snapshots to shared memory: -1 off, 0 on every change, else throttle
+    double depthTickSize = 0.01;                                // price ladder of the L2 depth profile
+    int depthBucketTicks = 1;                                   // ticks per depth bucket
+    int depthLadderBuckets = 256;                               // buckets kept per bar; depth beyond them folds into the edges
+    size_t dbBatchRows = 500;                                   // most rows the database writer commits at once
+    int dbFlushMs = 200;                                        // longest a queued row waits for others to share its commit
+};
+
+// Path prefixes of the raw TWS capture journals; empty disables capture.
+struct JournalConfig {
+    std::string realtime;
+    std::string daily;
+};
+
+// Parses "1s", "5m", "1h" or a bare number of seconds; returns 0 when malformed.
+inline int parseBarResolution(const std::string& label) {
+    if (label.empty()) return 0;
+
+    int multiplier = 1;
+    std::string digits = label;
+    switch (label.back()) {
+        case 's': digits.pop_back(); break;
+        case 'm': multiplier = 60; digits.pop_back(); break;
+        case 'h': multiplier = 3600; digits.pop_back(); break;
+        default: break;
+    }
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) return 0;
+    return std::stoi(digits) * multiplier;
+}
+
+inline std::vector<int> parseBarResolutions(const std::string& list) {
+    std::vector<int> resolutions;
+    std::istringstream iss(list);
+    std::string entry;
+    while (std::getline(iss, entry, ',')) {
+        entry.erase(std::remove_if(entry.begin(), entry.end(), ::isspace), entry.end());
+        if (entry.empty()) continue;
+
+        int seconds = parseBarResolution(entry);
+        if (seconds <= 0) {
+            throw std::runtime_error("Invalid bar resolution: " + entry);
+        }
+        resolutions.push_back(seconds);
+    }
+    std::sort(resolutions.begin(), resolutions.end());
+    resolutions.erase(std::unique(resolutions.begin(), resolutions.end()), resolutions.end());
+    return resolutions;
+}
+
+inline DBConfig loadConfig(const std::string& configFilePath, const std::shared_ptr<Logger>& logger) {
     DBConfig config;
     boost::property_tree::ptree pt;
 
@@ -53,6 +122,7 @@ DBConfig loadConfig(const std::string& configFilePath, const std::shared_ptr<Log
         config.dbname = pt.get<std::string>(section + ".dbname");
         config.user = pt.get<std::string>(section + ".user");
         config.password = pt.get<std::string>(section + ".password");
+        config.poolSize = std::max<size_t>(1, pt.get<size_t>(section + ".pool_size", config.poolSize));
 
         std::string success_info = std::string("Using ") + (useCloud ? "cloud" : "local") + " database configuration.";
 
@@ -65,4 +135,140 @@ DBConfig loadConfig(const std::string& configFilePath, const std::shared_ptr<Log
 
     return config;
 }
+// Optional [realtime] section, e.g.
+//   [realtime]
+//   symbols = SPY,QQQ,AAPL:NASDAQ
+//   exchange = ARCA
+//   shards = 4
+//   workers = 4
+//   worker_cpus = 2,3,4,5
+//   bars = 1s,5s,1m,5m,15m
+//   db_bars = 1m,5m,15m
+//   shm_history = 256
+//   tick_by_tick = false
+//   book_snapshot_ms = 100
+//   depth_tick_size = 0.01
+//   depth_bucket_ticks = 5
+//   depth_ladder_buckets = 256
+//   db_batch_rows = 500
+//   db_flush_ms = 200
+// Entries without ":EXCHANGE" use `exchange`, ARCA by default; SMART routes the
+// quotes and requests SMART depth, with no primary exchange. A missing section keeps the
+// SPY-only defaults.
+// Symbols are split into `shards` units of work that run on a fixed pool of `workers` threads;
+// `worker_cpus` starts one worker per listed CPU and pins it there instead.
+// Every resolution in `bars` is published to shared memory, keeping the last `shm_history` bars;
+// `db_bars` defaults to all of them and may only list resolutions that are in `bars`.
+// `tick_by_tick` builds bars from exchange-timestamped trades and adds quote features;
+// TWS allows it on fewer symbols than reqMktData.
+// `book_snapshot_ms` adds one snapshot channel per symbol (resolution 0) that receives the
+// book features at most every that many milliseconds while the book changes; 0 publishes
+// after every drained batch of depth updates, and a missing key disables snapshots.
+// The L2 column is a depth profile on a fixed ladder of `depth_bucket_ticks` x `depth_tick_size`
+// buckets, so the same bucket covers the same prices in every bar.
+// Queued rows are written in group commits of up to `db_batch_rows` rows; a row waits at most
+// `db_flush_ms` for others to join it, and a backlog goes out in full batches with no wait.
+inline RealTimeConfig loadRealTimeConfig(const std::string& configFilePath, const std::shared_ptr<Logger>& logger) {
+    RealTimeConfig config;
+    boost::property_tree::ptree pt;
+
+    try {
+        boost::property_tree::ini_parser::read_ini(configFilePath, pt);
+
+        auto symbolList = pt.get_optional<std::string>("realtime.symbols");
+        if (symbolList) {
+            std::string defaultExchange = pt.get<std::string>("realtime.exchange", "ARCA");
+            std::vector<SymbolConfig> symbols;
+            std::istringstream iss(*symbolList);
+            std::string entry;
+            while (std::getline(iss, entry, ',')) {
+                entry.erase(std::remove_if(entry.begin(), entry.end(), ::isspace), entry.end());
+                if (entry.empty()) continue;
+
+                size_t colon = entry.find(':');
+                if (colon == std::string::npos) {
+                    symbols.push_back({entry, defaultExchange});
+                } else {
+                    symbols.push_back({entry.substr(0, colon), entry.substr(colon + 1)});
+                }
+            }
+            if (!symbols.empty()) config.symbols = symbols;
+        }
+
+        size_t defaultShards = std::max(1u, std::thread::hardware_concurrency());
+        config.shards = std::max<size_t>(1, pt.get<size_t>("realtime.shards", defaultShards));
+        config.workers = std::max<size_t>(1, pt.get<size_t>("realtime.workers", std::min<size_t>(config.shards, defaultShards)));
+
+        auto cpuList = pt.get_optional<std::string>("realtime.worker_cpus");
+        if (cpuList) {
+            std::istringstream iss(*cpuList);
+            std::string cpu;
+            while (std::getline(iss, cpu, ',')) {
+                cpu.erase(std::remove_if(cpu.begin(), cpu.end(), ::isspace), cpu.end());
+                if (!cpu.empty()) config.workerCpus.push_back(std::stoi(cpu));
+            }
+        }
+
+        auto barList = pt.get_optional<std::string>("realtime.bars");
+        if (barList) {
+            config.barResolutions = parseBarResolutions(*barList);
+            config.databaseResolutions = config.barResolutions;
+        }
+        auto databaseBarList = pt.get_optional<std::string>("realtime.db_bars");
+        if (databaseBarList) {
+            config.databaseResolutions = parseBarResolutions(*databaseBarList);
+        }
+        for (int seconds : config.databaseResolutions) {
+            if (std::find(config.barResolutions.begin(), config.barResolutions.end(), seconds) == config.barResolutions.end()) {
+                throw std::invalid_argument("realtime.db_bars resolution " + std::to_string(seconds) + "s is not in realtime.bars");
+            }
+        }
+        config.sharedMemoryHistory = std::max<uint32_t>(1, pt.get<uint32_t>("realtime.shm_history", config.sharedMemoryHistory));
+        config.tickByTick = pt.get<bool>("realtime.tick_by_tick", config.tickByTick);
+        config.bookSnapshotMs = std::max(-1, pt.get<int>("realtime.book_snapshot_ms", config.bookSnapshotMs));
+        config.depthTickSize = pt.get<double>("realtime.depth_tick_size", config.depthTickSize);
+        if (config.depthTickSize <= 0.0) {
+            throw std::invalid_argument("realtime.depth_tick_size must be positive");
+        }
+        config.depthBucketTicks = std::max(1, pt.get<int>("realtime.depth_bucket_ticks", config.depthBucketTicks));
+        config.depthLadderBuckets = std::max(2, pt.get<int>("realtime.depth_ladder_buckets", config.depthLadderBuckets));
+        config.dbBatchRows = std::max<size_t>(1, pt.get<size_t>("realtime.db_batch_rows", config.dbBatchRows));
+        config.dbFlushMs = std::max(0, pt.get<int>("realtime.db_flush_ms", config.dbFlushMs));
+
+        STX_LOGI(logger, "Real-time universe: " + std::to_string(config.symbols.size()) + " symbols across " + std::to_string(config.shards) + " shards on " +
+                 std::to_string(config.workerCpus.empty() ? config.workers : config.workerCpus.size()) + " workers.");
+    } catch (const std::exception& e) {
+        std::string failure_info = std::string("Error reading real-time configuration: ") + e.what();
+        STX_LOGE(logger, failure_info);
+        throw;
+    }
+
+    return config;
+}
+
+// Optional [journal] section, e.g.
+//   [journal]
+//   realtime = journals/realtime
+//   daily = journals/daily
+// Every connection writes <prefix>_<YYYYmmdd-HHMMSS>.stxj, replayable with `OpenSTX <level> replay ...`.
+inline JournalConfig loadJournalConfig(const std::string& configFilePath, const std::shared_ptr<Logger>& logger) {
+    JournalConfig config;
+    boost::property_tree::ptree pt;
+
+    try {
+        boost::property_tree::ini_parser::read_ini(configFilePath, pt);
+        config.realtime = pt.get<std::string>("journal.realtime", "");
+        config.daily = pt.get<std::string>("journal.daily", "");
+        if (!config.realtime.empty() || !config.daily.empty()) {
+            STX_LOGI(logger, "TWS journal capture enabled. realtime: '" + config.realtime + "', daily: '" + config.daily + "'");
+        }
+    } catch (const std::exception& e) {
+        std::string failure_info = std::string("Error reading journal configuration: ") + e.what();
+        STX_LOGE(logger, failure_info);
+        throw;
+    }
+
+    return config;
+}
+
 #endif
\ No newline at end of file
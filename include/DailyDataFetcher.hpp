@@ -40,6 +40,8 @@
 
 #include "Logger.hpp"
 #include "TimescaleDB.hpp"
+#include "Indicators.hpp"
+#include "TwsJournal.hpp"
 
 struct DataItem {
     std::string date;
@@ -59,6 +61,9 @@ public:
     
     void stop();
     bool fetchAndProcessDailyData(const std::string& symbol, const std::string& duration, bool incremental);
+    // Offline mode: decodes a journal captured while fetching `symbol` and stores its bars.
+    bool replay(const std::string& symbol, const std::string& journalFile, double speed);
+    inline void setJournalPath(const std::string& prefix) { journalPath = prefix; }
     inline const bool isRunning() const { return running.load(); }
 
 private:
@@ -67,6 +72,8 @@ private:
     std::unique_ptr<EReaderOSSignal> osSignal;
     std::unique_ptr<EClientSocket> client;
     std::unique_ptr<EReader> reader;
+    std::string journalPath;
+    std::unique_ptr<TwsJournalWriter> journal;
     std::atomic<bool> running;
     bool dataReceived;
     int nextRequestId;
@@ -92,18 +99,12 @@ private:
     static constexpr int IB_PORT = 7496;
     static constexpr int IB_CLIENT_ID = 2;
 
-    std::map<std::string, std::deque<double>> closingPrices;
-    std::map<std::string, double> emaValues;
-    std::map<std::string, int> emaDataPoints;
-    std::map<std::string, std::deque<double>> gains;
-    std::map<std::string, std::deque<double>> losses;
-    std::map<std::string, double> lastClose;
-    std::map<std::string, double> cumulativePriceVolume;
-    std::map<std::string, double> cumulativeVolume;
-    static constexpr int maxPeriod = 26;
+    std::map<std::string, DailyIndicators> indicators;
+    static constexpr int maxPeriod = 35;   // slow MACD EMA (26) + signal EMA (9)
 
 private:
     bool connectToIB(int maxRetries = 3, int retryDelayMs = 2000);
+    void openJournal();
     bool waitForData(); 
     void maintainConnection();
     bool requestDailyData(const std::string& symbol, const std::string& startDate, const std::string& endDate, const std::string& barSize);
@@ -121,13 +122,6 @@ private:
     void initializeIndicatorData(const std::string& symbol, int period);
     std::string convertDateToIBFormat(const std::string& date);
 
-    double calculateSMA(const std::string& symbol, double close, int period = 20);
-    double calculateEMA(const std::string& symbol, double close, int period = 20);
-    double calculateRSI(const std::string& symbol, double close, int period = 14);
-    double calculateMACD(const std::string& symbol, double close);
-    double calculateVWAP(const std::string& symbol, double volume, double close);
-    double calculateMomentum(const std::string& symbol, double close, int period = 10);
-
     void historicalData(TickerId reqId, const Bar& bar) override;
     void historicalDataEnd(int reqId, const std::string& startDateStr, const std::string& endDateStr) override;
     void error(int id, int errorCode, const std::string &errorString, const std::string &advancedOrderRejectJson) override;
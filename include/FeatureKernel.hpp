@@ -0,0 +1,126 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef FEATURE_KERNEL_H
+#define FEATURE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "OrderBook.hpp"
+#include "TickEvent.hpp"
+#include "TopOfBook.hpp"
+
+// Everything derived from the order book, in O(1) from the book's running side
+// totals and best rows; cheap enough to evaluate after every book change.
+struct BookFeatures {
+    Quantity bidVolume = 0;
+    Quantity askVolume = 0;
+    double buySellRatio = 0.0;      // bid volume / ask volume
+    Quantity depthChange = 0;       // bid volume - ask volume
+    double impliedLiquidity = 0.0;  // (average bid size + average ask size) / spread
+};
+
+BookFeatures computeBookFeatures(const OrderBook& book);
+
+// Tick-by-tick trades and quotes seen during one bar. Counts only, so the
+// features of a coarse bar are the merge of its finer ones. The quoted spread
+// is not kept here: every tick-by-tick quote also updates the TopOfBook that
+// MicrostructureFeatures samples, which yields the bar's one spread column.
+struct TickFeatures {
+    uint64_t trades = 0;
+    uint64_t quotes = 0;          // bid and ask updates
+    Quantity tradeVolume = 0;
+
+    inline bool empty() const { return trades == 0 && quotes == 0; }
+
+    inline void merge(const TickFeatures& later) {
+        trades += later.trades;
+        quotes += later.quotes;
+        tradeVolume += later.tradeVolume;
+    }
+
+    inline void reset() { *this = TickFeatures(); }
+};
+
+// Folds `count` events, in arrival order, into `features`.
+void accumulateTickFeatures(TickFeatures& features, const TickEvent* events, size_t count);
+
+// Top-of-book microstructure of one bar, sampled in place on every quote update
+// and every signed trade. Like TickFeatures it only holds counts and sums, so a
+// coarse bar is the merge of its finer ones; the last microprice carries over.
+struct MicrostructureFeatures {
+    uint64_t quoteSamples = 0;
+    double spreadSum = 0.0;
+    double imbalanceSum = 0.0;
+    double microprice = 0.0;      // at the latest two-sided quote
+    uint64_t buyTrades = 0;
+    uint64_t sellTrades = 0;
+    Quantity buyVolume = 0;
+    Quantity sellVolume = 0;
+
+    inline void sampleQuote(const TopOfBook& quote) {
+        if (!quote.valid()) return;
+        ++quoteSamples;
+        spreadSum += quote.spread();
+        imbalanceSum += quote.imbalance();
+        microprice = quote.microprice();
+    }
+
+    inline void addTrade(int sign, Quantity size) {
+        if (sign > 0) {
+            ++buyTrades;
+            buyVolume += size;
+        } else if (sign < 0) {
+            ++sellTrades;
+            sellVolume += size;
+        }
+    }
+
+    inline double meanSpread() const { return quoteSamples == 0 ? 0.0 : spreadSum / quoteSamples; }
+    inline double meanImbalance() const { return quoteSamples == 0 ? 0.0 : imbalanceSum / quoteSamples; }
+    inline Quantity signedVolume() const { return buyVolume - sellVolume; }
+    // (buy volume - sell volume) / signed volume traded, in [-1, 1].
+    inline double orderFlowImbalance() const {
+        const Quantity total = buyVolume + sellVolume;
+        return total <= 0 ? 0.0 : static_cast<double>(buyVolume - sellVolume) / static_cast<double>(total);
+    }
+    inline bool empty() const { return quoteSamples == 0 && buyTrades == 0 && sellTrades == 0; }
+
+    inline void merge(const MicrostructureFeatures& later) {
+        quoteSamples += later.quoteSamples;
+        spreadSum += later.spreadSum;
+        imbalanceSum += later.imbalanceSum;
+        if (later.microprice > 0.0) microprice = later.microprice;
+        buyTrades += later.buyTrades;
+        sellTrades += later.sellTrades;
+        buyVolume += later.buyVolume;
+        sellVolume += later.sellVolume;
+    }
+
+    inline void reset() {
+        const double last = microprice;
+        *this = MicrostructureFeatures();
+        microprice = last;
+    }
+};
+
+#endif // FEATURE_KERNEL_H
@@ -0,0 +1,131 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "Decimal.h"
+
+// Sizes and volumes as int64 scaled by 10^QUANTITY_DECIMALS. TWS sizes arrive
+// as BID64 Decimal; they are decoded once on arrival straight from the bit
+// layout (no IntelRDFPMathLib call), aggregated with plain integer arithmetic,
+// and encoded back to Decimal only when serialized.
+using Quantity = int64_t;
+
+constexpr int QUANTITY_DECIMALS = 4;
+constexpr Quantity QUANTITY_SCALE = 10000;
+constexpr Quantity UNSET_QUANTITY = std::numeric_limits<Quantity>::min();
+
+namespace fixed_point_detail {
+constexpr int BID64_EXPONENT_BIAS = 398;
+constexpr uint64_t BID64_SIGN_MASK = 0x8000000000000000ull;
+constexpr uint64_t BID64_SPECIAL_MASK = 0x7800000000000000ull;       // infinity / NaN
+constexpr uint64_t BID64_LARGE_COEFFICIENT_MASK = 0x6000000000000000ull;
+constexpr uint64_t BID64_SMALL_COEFFICIENT_BITS = 0x001fffffffffffffull;
+constexpr uint64_t BID64_LARGE_COEFFICIENT_BITS = 0x0007ffffffffffffull;
+constexpr uint64_t BID64_LARGE_COEFFICIENT_IMPLICIT = 0x0020000000000000ull;
+constexpr uint64_t BID64_MAX_SMALL_COEFFICIENT = 0x001fffffffffffffull;
+
+constexpr uint64_t POWERS_OF_TEN[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull
+};
+constexpr int MAX_POWER_OF_TEN = 18;
+}
+
+// Decodes a BID64 value to a scaled quantity, rounding half away from zero.
+// Infinity and NaN (including UNSET_DECIMAL) map to UNSET_QUANTITY; values
+// beyond the int64 range saturate.
+inline Quantity decimalToQuantity(Decimal value) {
+    using namespace fixed_point_detail;
+    const uint64_t bits = value;
+    if ((bits & BID64_SPECIAL_MASK) == BID64_SPECIAL_MASK) return UNSET_QUANTITY;
+
+    int exponent;
+    uint64_t coefficient;
+    if ((bits & BID64_LARGE_COEFFICIENT_MASK) == BID64_LARGE_COEFFICIENT_MASK) {
+        exponent = static_cast<int>((bits >> 51) & 0x3ff);
+        coefficient = (bits & BID64_LARGE_COEFFICIENT_BITS) | BID64_LARGE_COEFFICIENT_IMPLICIT;
+    } else {
+        exponent = static_cast<int>((bits >> 53) & 0x3ff);
+        coefficient = bits & BID64_SMALL_COEFFICIENT_BITS;
+    }
+
+    const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<Quantity>::max());
+    int shift = exponent - BID64_EXPONENT_BIAS + QUANTITY_DECIMALS;
+    if (shift >= 0) {
+        for (; shift > 0 && coefficient != 0; --shift) {
+            if (coefficient > limit / 10) {
+                coefficient = limit;
+                break;
+            }
+            coefficient *= 10;
+        }
+    } else if (-shift > MAX_POWER_OF_TEN) {
+        coefficient = 0;
+    } else {
+        const uint64_t divisor = POWERS_OF_TEN[-shift];
+        coefficient = coefficient / divisor + (coefficient % divisor >= (divisor + 1) / 2 ? 1 : 0);
+    }
+
+    const Quantity magnitude = static_cast<Quantity>(coefficient > limit ? limit : coefficient);
+    return (bits & BID64_SIGN_MASK) ? -magnitude : magnitude;
+}
+
+// Encodes a scaled quantity as BID64 with trailing zeros folded into the
+// exponent, so whole share counts serialize exactly like the sizes TWS sends.
+inline Decimal quantityToDecimal(Quantity quantity) {
+    using namespace fixed_point_detail;
+    if (quantity == UNSET_QUANTITY) return UNSET_DECIMAL;
+
+    const uint64_t sign = quantity < 0 ? BID64_SIGN_MASK : 0;
+    uint64_t coefficient = quantity < 0 ? 0 - static_cast<uint64_t>(quantity) : static_cast<uint64_t>(quantity);
+    int exponent = BID64_EXPONENT_BIAS - QUANTITY_DECIMALS;
+    if (coefficient == 0) {
+        exponent = BID64_EXPONENT_BIAS;
+    }
+    while (coefficient != 0 && coefficient % 10 == 0 && exponent < BID64_EXPONENT_BIAS) {
+        coefficient /= 10;
+        ++exponent;
+    }
+    while (coefficient > BID64_MAX_SMALL_COEFFICIENT) {
+        coefficient /= 10;
+        ++exponent;
+    }
+    return sign | (static_cast<uint64_t>(exponent) << 53) | coefficient;
+}
+
+inline double quantityToDouble(Quantity quantity) {
+    return static_cast<double>(quantity) / QUANTITY_SCALE;
+}
+
+// Rounds to the nearest representable quantity; for derived averages, not for TWS sizes.
+inline Quantity doubleToQuantity(double value) {
+    return static_cast<Quantity>(std::llround(value * QUANTITY_SCALE));
+}
+
+#endif // FIXED_POINT_H
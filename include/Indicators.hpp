@@ -0,0 +1,328 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Streaming technical indicators shared by the real-time and the daily paths.
+// Every update() is O(1): windowed indicators keep running sums over a fixed
+// circular window, smoothed ones (EMA, Wilder RSI/ATR) keep only their state.
+// value() is always defined; ready() tells whether a full period has been seen.
+
+// Fixed-capacity circular window of the most recent values.
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity) : values(capacity) {
+        if (capacity == 0) throw std::invalid_argument("RollingWindow capacity must be positive");
+    }
+
+    // Appends `value`. When the window was already full the oldest value is
+    // overwritten, returned through `evicted`, and the call returns true.
+    inline bool push(double value, double& evicted) {
+        const bool wasFull = full();
+        evicted = values[next];
+        values[next] = value;
+        next = next + 1 == values.size() ? 0 : next + 1;
+        if (!wasFull) ++count;
+        return wasFull;
+    }
+
+    inline double oldest() const { return values[full() ? next : 0]; }
+    inline size_t size() const { return count; }
+    inline size_t capacity() const { return values.size(); }
+    inline bool full() const { return count == values.size(); }
+
+private:
+    std::vector<double> values;
+    size_t next = 0;
+    size_t count = 0;
+};
+
+// Simple moving average; the mean of the values seen so far until the window fills.
+class SmaIndicator {
+public:
+    explicit SmaIndicator(size_t period) : window(period) {}
+
+    inline double update(double value) {
+        double evicted;
+        sum += value;
+        if (window.push(value, evicted)) sum -= evicted;
+        return this->value();
+    }
+
+    inline double value() const { return window.size() == 0 ? 0.0 : sum / window.size(); }
+    inline bool ready() const { return window.full(); }
+
+private:
+    RollingWindow window;
+    double sum = 0.0;
+};
+
+// Exponential moving average seeded with the SMA of the first `period` values.
+class EmaIndicator {
+public:
+    explicit EmaIndicator(size_t period) : period(period), multiplier(2.0 / (period + 1.0)) {
+        if (period == 0) throw std::invalid_argument("EmaIndicator period must be positive");
+    }
+
+    inline double update(double value) {
+        if (count < period) {
+            ++count;
+            current += (value - current) / count;   // running mean while seeding
+        } else {
+            current += (value - current) * multiplier;
+        }
+        return current;
+    }
+
+    inline double value() const { return current; }
+    inline bool ready() const { return count >= period; }
+
+private:
+    size_t period;
+    double multiplier;
+    size_t count = 0;
+    double current = 0.0;
+};
+
+// Wilder's RSI: simple average of the first `period` changes, then Wilder smoothing.
+// Neutral (50) until `period` changes have been seen.
+class RsiIndicator {
+public:
+    explicit RsiIndicator(size_t period = 14) : period(period) {
+        if (period == 0) throw std::invalid_argument("RsiIndicator period must be positive");
+    }
+
+    inline double update(double close) {
+        if (!hasPrevious) {
+            previousClose = close;
+            hasPrevious = true;
+            return value();
+        }
+
+        const double change = close - previousClose;
+        const double gain = std::max(change, 0.0);
+        const double loss = std::max(-change, 0.0);
+        previousClose = close;
+
+        if (count < period) {
+            ++count;
+            averageGain += (gain - averageGain) / count;
+            averageLoss += (loss - averageLoss) / count;
+        } else {
+            averageGain = (averageGain * (period - 1) + gain) / period;
+            averageLoss = (averageLoss * (period - 1) + loss) / period;
+        }
+        return value();
+    }
+
+    inline double value() const {
+        if (!ready()) return 50.0;
+        if (averageLoss == 0.0) return averageGain == 0.0 ? 50.0 : 100.0;
+        return 100.0 - 100.0 / (1.0 + averageGain / averageLoss);
+    }
+
+    inline bool ready() const { return count >= period; }
+
+private:
+    size_t period;
+    size_t count = 0;
+    bool hasPrevious = false;
+    double previousClose = 0.0;
+    double averageGain = 0.0;
+    double averageLoss = 0.0;
+};
+
+// MACD line (fast EMA - slow EMA), its signal EMA and the histogram.
+// All three stay at 0 until the slow EMA is seeded.
+class MacdIndicator {
+public:
+    MacdIndicator(size_t fastPeriod = 12, size_t slowPeriod = 26, size_t signalPeriod = 9)
+        : fast(fastPeriod), slow(slowPeriod), signalLine(signalPeriod) {}
+
+    inline double update(double close) {
+        fast.update(close);
+        slow.update(close);
+        if (slow.ready()) {
+            macd = fast.value() - slow.value();
+            signalLine.update(macd);
+        }
+        return macd;
+    }
+
+    inline double value() const { return macd; }
+    inline double signal() const { return slow.ready() ? signalLine.value() : 0.0; }
+    inline double histogram() const { return value() - signal(); }
+    inline bool ready() const { return slow.ready(); }
+
+private:
+    EmaIndicator fast;
+    EmaIndicator slow;
+    EmaIndicator signalLine;
+    double macd = 0.0;
+};
+
+// Volume-weighted average price, cumulative when `window` is 0, otherwise over
+// the last `window` updates. Falls back to the last price while volume is zero.
+class VwapIndicator {
+public:
+    explicit VwapIndicator(size_t window = 0)
+        : priceVolumes(std::max<size_t>(window, 1)), volumes(std::max<size_t>(window, 1)), rolling(window > 0) {}
+
+    inline double update(double price, double volume) {
+        const double priceVolume = price * volume;
+        totalPriceVolume += priceVolume;
+        totalVolume += volume;
+        if (rolling) {
+            double evicted;
+            if (priceVolumes.push(priceVolume, evicted)) totalPriceVolume -= evicted;
+            if (volumes.push(volume, evicted)) totalVolume -= evicted;
+        }
+        lastPrice = price;
+        return value();
+    }
+
+    inline double value() const { return totalVolume > 0.0 ? totalPriceVolume / totalVolume : lastPrice; }
+
+private:
+    RollingWindow priceVolumes;
+    RollingWindow volumes;
+    bool rolling;
+    double totalPriceVolume = 0.0;
+    double totalVolume = 0.0;
+    double lastPrice = 0.0;
+};
+
+// Change between the latest close and the close `period` updates earlier
+// (or the oldest close seen, until that many updates have arrived).
+class MomentumIndicator {
+public:
+    explicit MomentumIndicator(size_t period = 10) : window(period + 1) {}
+
+    inline double update(double close) {
+        double evicted;
+        window.push(close, evicted);
+        latest = close;
+        return value();
+    }
+
+    inline double value() const { return window.size() == 0 ? 0.0 : latest - window.oldest(); }
+    inline bool ready() const { return window.full(); }
+
+private:
+    RollingWindow window;
+    double latest = 0.0;
+};
+
+// Bollinger bands: SMA middle band +/- `width` population standard deviations.
+class BollingerIndicator {
+public:
+    explicit BollingerIndicator(size_t period = 20, double width = 2.0) : window(period), width(width) {}
+
+    inline double update(double close) {
+        double evicted;
+        sum += close;
+        sumSquares += close * close;
+        if (window.push(close, evicted)) {
+            sum -= evicted;
+            sumSquares -= evicted * evicted;
+        }
+        return middle();
+    }
+
+    inline double middle() const { return window.size() == 0 ? 0.0 : sum / window.size(); }
+    inline double deviation() const {
+        if (window.size() == 0) return 0.0;
+        const double mean = middle();
+        return std::sqrt(std::max(0.0, sumSquares / window.size() - mean * mean));
+    }
+    inline double upper() const { return middle() + width * deviation(); }
+    inline double lower() const { return middle() - width * deviation(); }
+    inline bool ready() const { return window.full(); }
+
+private:
+    RollingWindow window;
+    double width;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+};
+
+// Average true range with Wilder smoothing.
+class AtrIndicator {
+public:
+    explicit AtrIndicator(size_t period = 14) : period(period) {
+        if (period == 0) throw std::invalid_argument("AtrIndicator period must be positive");
+    }
+
+    inline double update(double high, double low, double close) {
+        double trueRange = high - low;
+        if (hasPrevious) {
+            trueRange = std::max({trueRange, std::fabs(high - previousClose), std::fabs(low - previousClose)});
+        }
+        previousClose = close;
+        hasPrevious = true;
+
+        if (count < period) {
+            ++count;
+            atr += (trueRange - atr) / count;
+        } else {
+            atr = (atr * (period - 1) + trueRange) / period;
+        }
+        return atr;
+    }
+
+    inline double value() const { return atr; }
+    inline bool ready() const { return count >= period; }
+
+private:
+    size_t period;
+    size_t count = 0;
+    bool hasPrevious = false;
+    double previousClose = 0.0;
+    double atr = 0.0;
+};
+
+// Streaming indicator state of one symbol, fed one daily bar at a time.
+struct DailyIndicators {
+    SmaIndicator sma{20};
+    EmaIndicator ema{20};
+    RsiIndicator rsi{14};
+    MacdIndicator macd{12, 26, 9};
+    VwapIndicator vwap;
+    MomentumIndicator momentum{10};
+
+    inline void update(double close, double volume) {
+        sma.update(close);
+        ema.update(close);
+        rsi.update(close);
+        macd.update(close);
+        vwap.update(close, volume);
+        momentum.update(close);
+    }
+};
+
+#endif // INDICATORS_H
@@ -0,0 +1,85 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include <array>
+#include <cstdint>
+
+#include "FixedPoint.hpp"
+
+// Side codes as sent by updateMktDepth.
+enum class BookSide : uint8_t {
+    Ask = 0,
+    Bid = 1
+};
+
+// Operation codes as sent by updateMktDepth.
+enum class BookOperation : uint8_t {
+    Insert = 0,
+    Update = 1,
+    Delete = 2
+};
+
+// Fixed-depth limit order book mirroring the rows maintained by TWS.
+// Each side is a pair of contiguous price/size arrays indexed by the `position`
+// of updateMktDepth: update writes one row, insert/delete shift the rows below
+// `position` by one, which is bounded by MAX_DEPTH. The total size resting on
+// each side is kept up to date on every change, so it never needs a rescan.
+class OrderBook {
+public:
+    static constexpr int MAX_DEPTH = 64;
+
+    OrderBook();
+
+    // Applies one updateMktDepth message; an UNSET_QUANTITY size counts as 0.
+    // Returns false for malformed input.
+    bool apply(int position, int operation, int side, double price, Quantity size);
+    void clear();
+
+    inline int depth(BookSide side) const { return levels[index(side)].depth; }
+    inline double price(BookSide side, int level) const { return levels[index(side)].prices[level]; }
+    inline Quantity size(BookSide side, int level) const { return levels[index(side)].sizes[level]; }
+    inline Quantity volume(BookSide side) const { return levels[index(side)].total; }
+    inline bool empty() const { return depth(BookSide::Bid) == 0 && depth(BookSide::Ask) == 0; }
+
+    inline double bestBid() const { return depth(BookSide::Bid) > 0 ? price(BookSide::Bid, 0) : 0.0; }
+    inline double bestAsk() const { return depth(BookSide::Ask) > 0 ? price(BookSide::Ask, 0) : 0.0; }
+
+private:
+    struct Levels {
+        std::array<double, MAX_DEPTH> prices;
+        std::array<Quantity, MAX_DEPTH> sizes;
+        int depth;
+        Quantity total;   // sum of sizes[0, depth)
+    };
+
+    static inline int index(BookSide side) { return static_cast<int>(side); }
+
+    void insert(Levels& side, int position, double price, Quantity size);
+    void update(Levels& side, int position, double price, Quantity size);
+    void remove(Levels& side, int position);
+
+    Levels levels[2];
+};
+
+#endif // ORDER_BOOK_H
@@ -0,0 +1,76 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#ifndef REAL_TIME_BAR_H
+#define REAL_TIME_BAR_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// One price-ladder bucket of a bar's depth profile: the average size that
+// rested there over the bar (size x seconds / bar seconds). One row of realtime_depth.
+struct DepthLevel {
+    double price = 0.0;
+    double bidSize = 0.0;
+    double askSize = 0.0;
+};
+
+// One finished bar as stored in realtime_bars, plus its depth profile for
+// realtime_depth. Volumes are in shares; tick and microstructure features are
+// empty (NULL) when the bar saw no ticks or quotes of that kind, and book
+// features when the symbol had no L2 book at the close.
+struct RealTimeBar {
+    std::string symbol;
+    int resolution = 0;
+    std::string datetime;            // bar boundary in UTC, "YYYY-MM-DD HH:MM:SS+00"
+
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    int64_t tradeCount = 0;
+
+    double weightedAvgPrice = 0.0;
+    double priceMomentum = 0.0;
+    double tradeDensity = 0.0;
+    double rsi = 0.0;
+    double macd = 0.0;
+    double vwap = 0.0;
+
+    std::optional<double> buySellRatio;
+    std::optional<double> depthChange;
+    std::optional<double> impliedLiquidity;
+    std::optional<int64_t> tickTrades;
+    std::optional<int64_t> tickQuotes;
+    std::optional<double> spread;
+    std::optional<double> microprice;
+    std::optional<double> quoteImbalance;
+    std::optional<double> orderFlowImbalance;
+    std::optional<double> signedVolume;
+
+    std::vector<DepthLevel> depth;
+};
+
+#endif // REAL_TIME_BAR_H
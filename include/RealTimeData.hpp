@@ -39,124 +39,252 @@
 #include <set>
 #include <numeric>
 #include <condition_variable>
+#include <functional>
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include "EClientSocket.h"
 #include "EWrapper.h"
 #include "Decimal.h"
-#include "nlohmann/json.hpp"
 #include "Logger.hpp"
 #include "TimescaleDB.hpp"
+#include "Config.hpp"
+#include "Clock.hpp"
+#include "SpscRing.hpp"
+#include "OrderBook.hpp"
+#include "BarEngine.hpp"
+#include "FeatureKernel.hpp"
+#include "Indicators.hpp"
+#include "TickEvent.hpp"
+#include "TimeWeightedDepth.hpp"
+#include "BarPayload.hpp"
+#include "SharedMemoryBars.hpp"
+#include "TwsJournal.hpp"
+#include "ThreadPool.hpp"
 #include "EReaderOSSignal.h" // Include the header for EReaderOSSignal
 #include "EReader.h" // Include the header for EReader
 
-using json = nlohmann::json;
-
 class RealTimeData : public EWrapper {
 public:
-    RealTimeData(const std::shared_ptr<Logger>& log, const std::shared_ptr<TimescaleDB>& _db);
+    struct RingStats {
+        std::string symbol;
+        size_t l1Occupancy;
+        size_t l1HighWater;
+        uint64_t l1Dropped;
+        size_t l2Occupancy;
+        size_t l2HighWater;
+        uint64_t l2Dropped;
+        size_t tickOccupancy;
+        size_t tickHighWater;
+        uint64_t tickDropped;
+    };
+
+    // Takes over from TimescaleDB as the destination of the database writer thread.
+    using RowSink = std::function<bool(const RealTimeBar& bar)>;
+    // Runs on a pipeline worker right after a bar became visible in shared memory.
+    using PublishHook = std::function<void(size_t symbolIndex, int resolution, int64_t boundary, const OhlcvBar& bar)>;
+
+    RealTimeData(const std::shared_ptr<Logger>& log, const std::shared_ptr<TimescaleDB>& _db, const RealTimeConfig& config = RealTimeConfig());
     ~RealTimeData();
 
     bool start();
+    // Starts the shards, shared memory and database writer without connecting
+    // to TWS; messages are then fed through the EWrapper callbacks by the caller.
+    bool startOffline();
     void stop();
+    // Offline mode: decodes a captured TWS journal instead of connecting.
+    // speed 1 keeps the recorded pace, 0 replays as fast as possible.
+    bool replay(const std::string& journalFile, double speed);
+    inline void setJournalPath(const std::string& prefix) { journalPath = prefix; }
+    // Must be set before start(); a RealTimeData with a row sink needs no database.
+    inline void setRowSink(RowSink sink) { rowSink = std::move(sink); }
+    inline void setPublishHook(PublishHook hook) { publishHook = std::move(hook); }
+    // Time source of the bar boundaries and timers; wall time by default. Must be set before start().
+    inline void setClock(const std::shared_ptr<Clock>& _clock) { clock = _clock; }
     inline const bool isRunning() const { return running.load(); }
+    std::vector<RingStats> getRingStats() const;
+
+    // Streams requested per symbol; ticker ids are derived from (symbol index, stream)
+    // so routing a callback back to its symbol is plain arithmetic.
+    enum StreamType {
+        L1_STREAM = 0,
+        L2_STREAM = 1,
+        TICK_TRADE_STREAM = 2,   // reqTickByTickData "AllLast"
+        TICK_QUOTE_STREAM = 3,   // reqTickByTickData "BidAsk"
+        STREAMS_PER_SYMBOL
+    };
+
+    static TickerId tickerIdFor(size_t symbolIndex, StreamType stream);
 
 private:
-    struct L2DataPoint {
+
+    // Callback payloads, copied into the rings by the reader thread. Sizes are
+    // decoded from Decimal once, here, and stay integer from then on.
+    struct L1Event {
+        double price;
+        Quantity size;
+        TickType field;
+    };
+
+    struct L2Event {
         double price;
-        Decimal volume;
-        std::string side;
-        std::string status;
+        Quantity size;
+        int position;
+        int operation;
+        int side;
+    };
 
-        L2DataPoint() : price(0.0), volume(0), side(""), status("") {}
-        L2DataPoint(double p, Decimal v, const std::string& s, const std::string& st) : price(p), volume(v), side(s), status(st) {}
+    // Everything that used to be a single global buffer, now owned per symbol.
+    // The reader thread only touches the rings; all other members belong to the
+    // shard that drains them. A shard's tasks never overlap, so whichever worker
+    // runs them takes no lock on either side.
+    struct SymbolState {
+        size_t index;
+        Contract contract;
+
+        SpscRing<L1Event> l1Ring;
+        SpscRing<L2Event> l2Ring;
+        SpscRing<TickEvent> tickRing;
+        std::atomic<size_t> l1HighWater{0};
+        std::atomic<size_t> l2HighWater{0};
+        std::atomic<size_t> tickHighWater{0};
+        std::atomic<bool> bookResetPending{false};
+        uint32_t tickSequence = 0;   // reader thread only
+
+        SymbolState(size_t l1Capacity, size_t l2Capacity, size_t tickCapacity, const std::vector<int>& resolutions)
+            : index(0), l1Ring(l1Capacity), l2Ring(l2Capacity), tickRing(tickCapacity), bars(resolutions) {}
+
+        BarEngine bars;
+        std::vector<BarSeries> series;   // one per bar resolution, same order as the engine
+        OrderBook book;
+        std::vector<TickEvent> ticks;    // tick-by-tick events of the current second, in arrival order
+        TickFeatures tickFeatures;       // counts the events are folded into
+        TopOfBook quote;                 // best bid/ask from L1 or tick-by-tick quotes
+        TradeSigner signer;
+        double lastTradePrice = 0.0;     // L1 LAST waiting for its LAST_SIZE
+        MicrostructureFeatures micro;    // quote samples and signed trades of the current second
+        TimeWeightedDepth depth;         // how long each price rested at which size
+        bool bookChanged = false;        // depth updates applied since the last snapshot
+        Clock::TimePoint lastSnapshot;
+    };
+
+    // A bar closed by the aggregate stage, carried through the features and publish stages.
+    struct ClosedBar {
+        SymbolState* state;
+        size_t resolutionIndex;
+        int64_t boundary;
+        OhlcvBar bar;
+        bool ready;                      // payloads built; false skips publishing
+        RealTimeBar row;                 // database row, built for persisted resolutions only
+        SharedMemoryBarRecord record;
+    };
+
+    // A fixed subset of symbols aggregated as one unit of work of the task graphs.
+    struct Shard {
+        std::vector<SymbolState*> symbols;
+        std::vector<ClosedBar> closed;   // bars of the second being closed
     };
 
     std::shared_ptr<Logger> logger;
     std::shared_ptr<TimescaleDB> db;
+    RealTimeConfig config;
     std::unique_ptr<EReaderOSSignal> osSignal;
     std::unique_ptr<EClientSocket> client;
     std::unique_ptr<EReader> reader;
     OrderId nextOrderId;
-    int requestId;
     std::atomic<bool> running;
+    std::shared_ptr<Clock> clock;
 
     std::thread readerThread;
-    std::thread processDataThread;
     std::thread monitorDataFlowThread;
     std::thread databaseThread;
+    std::thread pipelineThread;
+
+    std::vector<std::unique_ptr<SymbolState>> symbolStates;
+    std::vector<Shard> shards;
+
+    // Every drain interval runs drainGraph (drain per shard); each second boundary runs
+    // secondGraph instead (drain -> aggregate -> features -> publish per shard). Both are
+    // built once and run on the same persistent pool.
+    std::unique_ptr<ThreadPool> workers;
+    TaskGraph drainGraph;
+    TaskGraph secondGraph;
+    // Time of the cycle being run, set by the pipeline thread before each graph run.
+    Clock::TimePoint cycleTime;
+    int64_t cycleNs = 0;
+    int64_t cycleSecond = 0;
+    std::queue<RealTimeBar> dataQueue;
 
-    std::vector<double> l1Prices;
-    std::vector<Decimal> l1Volumes;
-    std::map<int, std::vector<L2DataPoint>> rawL2Data;
-    std::vector<double> l1PricesBuffer;
-    std::vector<Decimal> l1VolumesBuffer;
-    std::map<int, std::vector<L2DataPoint>> rawL2DataBuffer;
-    std::queue<std::tuple<std::string, json, json, json>> dataQueue;
-    std::deque<double> historicalClosePrices;
-    std::deque<double> historicalVolumes;
-    const size_t MAX_HISTORY_SIZE = 60; 
-
-    std::condition_variable cv;
     std::condition_variable queueCV;
 
-    std::mutex dataMutex;
     std::mutex clientMutex;
     std::mutex readerMutex;
-    std::mutex cvMutex;
     std::mutex queueMutex;
 
     boost::interprocess::shared_memory_object shm;
     boost::interprocess::mapped_region region;
+    std::unique_ptr<SharedMemoryBarWriter> sharedMemoryWriter;
+
+    std::string journalPath;
+    std::unique_ptr<TwsJournalWriter> journal;
+
+    RowSink rowSink;
+    PublishHook publishHook;
 
     bool connectToIB(int maxRetries = 3, int retryDelayMs = 2000);
+    void openJournal();
     void initializeSharedMemory();
+    void initializeShards();
+    void buildTaskGraphs();
+    bool hasRowStore() const;
+    void startPipeline();
+
+    SymbolState* routeTicker(TickerId tickerId) const;
 
     void requestData(int maxRetries = 3, int retryDelayMs = 2000);
     void requestL1Data(int l1RequestId, const Contract& contract);
     void requestL2Data(int l2RequestID, const Contract& contract);
-    void processData();
-    void aggregateMinuteData();
-    json aggregateL1Data();
-    json aggregateL2Data();
+    void requestTickByTickData(size_t symbolIndex, const Contract& contract);
+    void runPipeline();
+    void drainShard(Shard& shard);
+    void aggregateShard(Shard& shard);
+    void buildShardPayloads(Shard& shard);
+    void publishShard(Shard& shard);
+    void drainRings(SymbolState& state, int64_t nowNs);
+    void applyL1Event(SymbolState& state, const L1Event& event);
+    void applyL2Event(SymbolState& state, const L2Event& event, int64_t nowNs);
+    void applyTickEvent(SymbolState& state, const TickEvent& event);
+    void signTrade(SymbolState& state, double price, Quantity size);
+    void closeSecond(SymbolState& state, int64_t nowNs);
+    void pushTickEvent(SymbolState& state, const TickEvent& event);
+    RealTimeBar buildRow(const BarSeries& series, const BookFeatures* bookFeatures);
     Contract createContract(const std::string& symbol, const std::string& secType, const std::string& exchange, const std::string& currency);
 
     void handleConnectionError(int errorCode);
     void handleRateLimitExceeded();
 
-    void updateHistoricalData();
-    json calculateFeatures(const json& l1Data, const json& l2Data);
     std::string getCurrentDateTime() const;
-    std::string createCombinedJson(const std::string& datetime, const json& l1Data, const json& l2Data, const json& features) const;
-    void writeToSharedMemory(const std::string &data);
-    void addToQueue(const std::string& datetime, const json& l1Data, const json& l2Data, const json& features);
+    std::string formatDateTime(std::time_t time) const;
+    size_t sharedMemoryChannel(const SymbolState& state, size_t resolutionIndex) const;
+    size_t snapshotChannel(const SymbolState& state) const;
+    SharedMemoryBarRecord barRecord(const SymbolState& state, size_t resolutionIndex, int64_t boundary, const BookFeatures& bookFeatures) const;
+    void publishBookSnapshot(SymbolState& state, Clock::TimePoint now);
+    void addToQueue(RealTimeBar&& row);
     void writeToDatabaseFunc();
+    bool storeRows(std::vector<RealTimeBar>& rows);
     
-    void swapBuffers();
-    void moveDeletedItemsToBuffer();
-    void clearBufferData();
-    void clearTemporaryData();
-    int countL2data(const std::map<int, std::vector<L2DataPoint>>& l2data) const;
 
     void reconnect();
     void monitorDataFlow(int maxRetries, int retryDelayMs, int checkIntervalMs);
     void joinThreads();
 
-    double calculateWeightedAveragePrice() const;
-    double calculateBuySellRatio() const;
-    Decimal calculateDepthChange() const;
-    double calculateImpliedLiquidity() const;
-    double calculatePriceMomentum() const;
-    double calculateTradeDensity() const;
-    double calculateRSI() const;
-    double calculateMACD() const;
-    double calculateEMA(int period) const;
-    double calculateVWAP() const;
     
     // EWrapper interface methods
     void tickPrice(TickerId tickerId, TickType field, double price, const TickAttrib &attrib) override;
     void tickSize(TickerId tickerId, TickType field, Decimal size) override;
     void updateMktDepth(TickerId id, int position, int operation, int side, double price, Decimal size) override;
+    void tickByTickAllLast(int reqId, int tickType, time_t time, double price, Decimal size, const TickAttribLast& tickAttribLast, const std::string& exchange, const std::string& specialConditions) override;
+    void tickByTickBidAsk(int reqId, time_t time, double bidPrice, double askPrice, Decimal bidSize, Decimal askSize, const TickAttribBidAsk& tickAttribBidAsk) override;
+    void tickByTickMidPoint(int reqId, time_t time, double midPoint) override;
     void error(int id, int errorCode, const std::string &errorString, const std::string &advancedOrderRejectJson) override;
     void nextValidId(OrderId orderId) override;
     
@@ -235,9 +363,6 @@ private:
     void historicalTicks(int reqId, const std::vector<HistoricalTick> &ticks, bool done) override {}
     void historicalTicksBidAsk(int reqId, const std::vector<HistoricalTickBidAsk> &ticks, bool done) override {}
     void historicalTicksLast(int reqId, const std::vector<HistoricalTickLast> &ticks, bool done) override {}
-    void tickByTickAllLast(int reqId, int tickType, time_t time, double price, Decimal size, const TickAttribLast& tickAttribLast, const std::string& exchange, const std::string& specialConditions) override {}
-    void tickByTickBidAsk(int reqId, time_t time, double bidPrice, double askPrice, Decimal bidSize, Decimal askSize, const TickAttribBidAsk& tickAttribBidAsk) override {}
-    void tickByTickMidPoint(int reqId, time_t time, double midPoint) override {}
     void orderBound(long long orderId, int apiClientId, int apiOrderId) override {}
     void completedOrder(const Contract& contract, const Order& order, const OrderState& orderState) override {}
     void completedOrdersEnd() override {}
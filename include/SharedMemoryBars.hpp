@@ -0,0 +1,152 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef SHARED_MEMORY_BARS_H
+#define SHARED_MEMORY_BARS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// Binary layout of the real-time shared memory segment (schema version 1):
+//
+//   [SharedMemoryHeader][SharedMemoryChannel x channelCount][SharedMemoryBarRecord x ringCapacity x channelCount]
+//
+// One channel per (symbol, bar resolution) holds a ring of the last
+// ringCapacity bars. Channels with resolution SHARED_MEMORY_SNAPSHOT_RESOLUTION
+// hold intra-bar book snapshots instead: the same record, stamped in epoch
+// milliseconds, with the open bar so far and the current book. Every channel is guarded by its own seqlock: the writer
+// makes `sequence` odd, writes one record, bumps `count` and makes `sequence`
+// even again. Readers never block the writer; they retry when `sequence` was
+// odd or changed while they were copying. All integers are little-endian.
+// py_script/readSharedMemory.py mirrors these structs and must be kept in sync.
+
+constexpr uint32_t SHARED_MEMORY_MAGIC = 0x42585453;   // "STXB"
+constexpr uint32_t SHARED_MEMORY_SCHEMA_VERSION = 1;
+constexpr size_t SHARED_MEMORY_SYMBOL_LENGTH = 16;
+constexpr int SHARED_MEMORY_SNAPSHOT_RESOLUTION = 0;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory seqlock needs lock-free 64-bit atomics");
+
+struct SharedMemoryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t channelSize;
+    uint32_t recordSize;
+    uint32_t channelCount;
+    uint32_t ringCapacity;
+    uint32_t quantityScale;              // volumes are integers scaled by this factor
+    std::atomic<uint64_t> writeSequence; // total records published, across all channels
+    uint64_t createdAt;                  // epoch seconds
+    uint64_t reserved[2];
+};
+
+struct SharedMemoryChannel {
+    char symbol[SHARED_MEMORY_SYMBOL_LENGTH];   // NUL-padded
+    int32_t resolution;                          // bar length in seconds
+    uint32_t reserved0;
+    std::atomic<uint64_t> sequence;              // seqlock, odd while a record is being written
+    std::atomic<uint64_t> count;                 // records written so far; the next slot is count % ringCapacity
+    uint64_t reserved[3];
+};
+
+struct SharedMemoryBarRecord {
+    int64_t timestamp;        // bar close boundary, epoch seconds (epoch ms for snapshots)
+    double open;
+    double high;
+    double low;
+    double close;
+    int64_t volume;           // scaled by quantityScale
+    uint64_t tradeCount;
+    double vwap;              // of this bar
+    double bestBid;
+    double bestAsk;
+    int64_t bidVolume;        // whole book, scaled by quantityScale
+    int64_t askVolume;
+    double buySellRatio;
+    double impliedLiquidity;
+    double priceMomentum;
+    double tradeDensity;
+    double rsi;
+    double macd;
+    double macdSignal;
+    double rollingVwap;       // over the indicator window
+};
+
+static_assert(sizeof(SharedMemoryHeader) == 64, "SharedMemoryHeader layout changed");
+static_assert(sizeof(SharedMemoryChannel) == 64, "SharedMemoryChannel layout changed");
+static_assert(sizeof(SharedMemoryBarRecord) == 160, "SharedMemoryBarRecord layout changed");
+
+// Channel description used to lay out a segment: symbol and resolution in seconds.
+using SharedMemoryChannelSpec = std::pair<std::string, int>;
+
+// Formats a caller-provided mapping and publishes records into it.
+// publish() must be called from a single thread per channel.
+class SharedMemoryBarWriter {
+public:
+    SharedMemoryBarWriter(void* address, size_t size, const std::vector<SharedMemoryChannelSpec>& channels, uint32_t ringCapacity);
+
+    static size_t requiredSize(size_t channelCount, uint32_t ringCapacity);
+
+    void publish(size_t channel, const SharedMemoryBarRecord& record);
+    inline size_t channelCount() const { return header->channelCount; }
+
+private:
+    SharedMemoryHeader* header;
+    SharedMemoryChannel* channels;
+    SharedMemoryBarRecord* records;
+};
+
+// Lock-free reader for a segment written by SharedMemoryBarWriter. Either
+// opens the named segment read-only or reads an existing mapping.
+class SharedMemoryBarReader {
+public:
+    explicit SharedMemoryBarReader(const std::string& name);
+    SharedMemoryBarReader(const void* address, size_t size);
+
+    // Index of the (symbol, resolution) channel, or -1 when it is not published.
+    int findChannel(const std::string& symbol, int resolution) const;
+    std::vector<SharedMemoryChannelSpec> listChannels() const;
+
+    // Latest record of a channel; false when nothing has been published yet.
+    bool latest(size_t channel, SharedMemoryBarRecord& record) const;
+    // Up to maxRecords most recent records of a channel, oldest first.
+    std::vector<SharedMemoryBarRecord> history(size_t channel, size_t maxRecords) const;
+
+    inline uint64_t writeSequence() const { return header->writeSequence.load(std::memory_order_acquire); }
+
+private:
+    void attach(const void* address, size_t size);
+
+    boost::interprocess::shared_memory_object shm;
+    boost::interprocess::mapped_region region;
+    const SharedMemoryHeader* header = nullptr;
+    const SharedMemoryChannel* channels = nullptr;
+    const SharedMemoryBarRecord* records = nullptr;
+};
+
+#endif // SHARED_MEMORY_BARS_H
@@ -0,0 +1,113 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#if defined(__APPLE__) && defined(__aarch64__)
+constexpr size_t CACHE_LINE_SIZE = 128;
+#else
+constexpr size_t CACHE_LINE_SIZE = 64;
+#endif
+
+// Bounded single-producer/single-consumer ring.
+// push() may only be called from one thread and pop()/drain() from one other thread.
+// A full ring rejects the new item and counts it as dropped instead of blocking the producer.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask(capacity - 1), buffer(std::make_unique<T[]>(capacity)) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("SpscRing capacity must be a power of two");
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    bool push(const T& item) {
+        const size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (currentTail - cachedHead > mask) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer[currentTail & mask] = item;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead == cachedTail) return false;
+        }
+        item = buffer[currentHead & mask];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands every item currently visible to `consume` and publishes the new head once.
+    template <typename Consumer>
+    size_t drain(Consumer&& consume) {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        cachedTail = tail.load(std::memory_order_acquire);
+        for (size_t i = currentHead; i != cachedTail; ++i) {
+            consume(buffer[i & mask]);
+        }
+        head.store(cachedTail, std::memory_order_release);
+        return cachedTail - currentHead;
+    }
+
+    size_t size() const {
+        const size_t currentHead = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - currentHead;
+    }
+
+    size_t capacity() const { return mask + 1; }
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    // Consumer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+
+    // Producer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> droppedCount{0};
+
+    const size_t mask;
+    std::unique_ptr<T[]> buffer;
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,104 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads started once and fed through one FIFO queue.
+// Worker i is pinned to cpus[i] when a CPU list is given, so the pool is as
+// wide as the cores reserved for it and no thread is created after startup.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // An empty `cpus` leaves placement to the OS; otherwise `workers` is ignored
+    // and one worker is started per listed CPU.
+    explicit ThreadPool(size_t workers, const std::vector<int>& cpus = {});
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    inline size_t size() const { return workers.size(); }
+    // Workers whose CPU affinity was applied; less than size() when pinning is unsupported or refused.
+    inline size_t pinned() const { return pinnedCount; }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    size_t pinnedCount = 0;
+};
+
+// Dependency graph of tasks built once and run many times. run() starts every
+// node without predecessors, each finished node releases its successors, and
+// the call returns when all nodes are done, so the caller sees the effects of
+// the whole graph. Nodes of one graph must not run it again from inside.
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    NodeId add(std::function<void()> work);
+    // `after` starts only once `before` has finished.
+    void precede(NodeId before, NodeId after);
+
+    // Rethrows the first exception thrown by a node, after every node has run.
+    void run(ThreadPool& workers);
+
+    inline size_t size() const { return nodes.size(); }
+
+private:
+    struct Node {
+        std::function<void()> work;
+        std::vector<NodeId> successors;
+        int predecessors = 0;
+        std::atomic<int> waiting{0};
+    };
+
+    void execute(NodeId id);
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<NodeId> roots;
+    ThreadPool* pool = nullptr;   // of the current run(), so a submitted closure is just {this, id} and fits std::function inline
+    std::atomic<size_t> remaining{0};
+    std::mutex doneMutex;
+    std::condition_variable doneCV;
+    std::exception_ptr failure;
+};
+
+#endif // THREAD_POOL_H
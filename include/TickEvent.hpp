@@ -0,0 +1,62 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#ifndef TICK_EVENT_H
+#define TICK_EVENT_H
+
+#include <cstdint>
+
+#include "FixedPoint.hpp"
+
+enum class TickKind : uint8_t {
+    Trade = 1,
+    Bid = 2,
+    Ask = 3,
+    MidPoint = 4
+};
+
+// Attribute bits of TickAttribLast / TickAttribBidAsk, stored above the kind byte.
+constexpr uint32_t TICK_PAST_LIMIT = 1u << 8;
+constexpr uint32_t TICK_UNREPORTED = 1u << 9;
+constexpr uint32_t TICK_BID_PAST_LOW = 1u << 10;
+constexpr uint32_t TICK_ASK_PAST_HIGH = 1u << 11;
+
+// One tick-by-tick trade or quote side. A BidAsk callback becomes a Bid and an
+// Ask event with the same timestamp and sequence.
+struct TickEvent {
+    int64_t timestamp;   // exchange time, epoch ns (TWS reports whole seconds)
+    double price;
+    Quantity size;       // 0 for midpoints
+    uint32_t flags;      // TickKind in the low byte, TICK_* attribute bits above it
+    uint32_t sequence;   // arrival order per symbol, breaks ties within a second
+
+    inline TickKind kind() const { return static_cast<TickKind>(flags & 0xff); }
+    inline bool has(uint32_t attribute) const { return (flags & attribute) != 0; }
+
+    static inline TickEvent make(int64_t epochSecond, double price, Quantity size, TickKind kind, uint32_t attributes, uint32_t sequence) {
+        return {epochSecond * 1000000000LL, price, size, static_cast<uint32_t>(kind) | attributes, sequence};
+    }
+};
+
+static_assert(sizeof(TickEvent) == 32, "TickEvent is a 32-byte record");
+
+#endif // TICK_EVENT_H
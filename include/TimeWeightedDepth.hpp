@@ -0,0 +1,135 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef TIME_WEIGHTED_DEPTH_H
+#define TIME_WEIGHTED_DEPTH_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "OrderBook.hpp"
+
+// Fixed price grid shared by every depth histogram of a run: prices snap to
+// integer ticks of `tickSize`, and `bucketTicks` ticks form one bucket. Bucket
+// numbers are absolute (price / bucket width), so a bucket covers the same
+// prices in every bar and profiles can be compared across time.
+struct PriceLadder {
+    double tickSize = 0.01;
+    int bucketTicks = 1;
+    int buckets = 256;        // window width of one histogram
+
+    inline int64_t bucketOf(double price) const {
+        const int64_t tick = std::llround(price / tickSize);
+        return tick >= 0 ? tick / bucketTicks : (tick - bucketTicks + 1) / bucketTicks;
+    }
+    // Centre price of an absolute bucket number.
+    inline double bucketPrice(int64_t bucket) const { return (bucket + 0.5) * bucketTicks * tickSize - 0.5 * tickSize; }
+};
+
+// Resting size integrated over time (size x seconds) per ladder bucket and
+// side, for one interval. Storage is a fixed window of `buckets` slots around
+// the first price seen since the last clear(), or around the window of the
+// first histogram merged in. Sizes outside the window are not attributed to any
+// price; they are summed in outsideSizeSeconds. Intervals merge by adding, so a
+// bar is the merge of its seconds.
+class DepthHistogram {
+public:
+    explicit DepthHistogram(const PriceLadder& ladder = PriceLadder());
+
+    // Places the window around `bucket` unless it is already placed.
+    void centre(int64_t bucket);
+    void add(BookSide side, int64_t bucket, double sizeSeconds);
+    void merge(const DepthHistogram& other);
+    // Zeroes the window in place; the next add() or centre() may move it.
+    void clear();
+
+    inline bool empty() const { return used == 0; }
+    inline const PriceLadder& ladder() const { return ladder_; }
+    // Occupied absolute bucket range, [firstBucket(), lastBucket()]; only meaningful when not empty.
+    inline int64_t firstBucket() const { return base + low; }
+    inline int64_t lastBucket() const { return base + high; }
+    inline double bidSizeSeconds(int64_t bucket) const { return bid[slot(bucket)]; }
+    inline double askSizeSeconds(int64_t bucket) const { return ask[slot(bucket)]; }
+
+    double seconds = 0.0;   // length of the interval covered
+    double outsideSizeSeconds = 0.0;   // both sides, outside the window
+
+private:
+    inline size_t slot(int64_t bucket) const { return static_cast<size_t>(bucket - base); }
+
+    PriceLadder ladder_;
+    std::vector<double> bid;
+    std::vector<double> ask;
+    int64_t base = 0;       // absolute bucket number of slot 0
+    int64_t low = 0;        // occupied slots [low, high]
+    int64_t high = -1;
+    size_t used = 0;        // in-window add() calls since clear()
+    bool placed = false;    // the window stays put until clear()
+};
+
+// Applies depth updates to an OrderBook and accounts for how long every
+// ladder bucket held which resting size. Each mutation only touches the rows
+// that enter or leave the book; untouched buckets are integrated lazily when
+// they change or when the interval is flushed.
+//
+// Resting sizes live in a fixed window of `buckets` slots per side, allocated
+// once. Levels outside the window share one accumulator per side. When the
+// touch drifts out of the middle half of the window, the window is re-centred
+// on it and rebuilt from the book.
+class TimeWeightedDepth {
+public:
+    explicit TimeWeightedDepth(const PriceLadder& ladder = PriceLadder());
+
+    // Same contract as OrderBook::apply; the change is stamped with nowNs.
+    bool apply(OrderBook& book, int position, int operation, int side, double price, Quantity size, int64_t nowNs);
+
+    // Integrates every resting level up to nowNs into histogram().
+    void flush(int64_t nowNs);
+    // Flushes and forgets every resting level, for a book that is being cleared.
+    void reset(int64_t nowNs);
+
+    inline const DepthHistogram& histogram() const { return accumulated; }
+    inline void clearHistogram() { accumulated.clear(); }
+
+private:
+    struct Resting {
+        Quantity size;
+        int64_t since;
+    };
+
+    void change(BookSide side, double price, Quantity delta, int64_t nowNs);
+    void integrate(BookSide side, int64_t bucket, Resting& level, int64_t nowNs);
+    void integrateAll(int64_t nowNs);
+    // Moves the window if the touch left its middle half; returns true when it
+    // was rebuilt from the book, which then already holds the latest change.
+    bool recentre(const OrderBook& book, int64_t nowNs);
+
+    PriceLadder ladder;
+    std::vector<Resting> resting[2];   // by offset from base
+    Resting outside[2] = {};           // every level outside the window
+    int64_t base = 0;                  // absolute bucket number of slot 0
+    bool anchored = false;
+    DepthHistogram accumulated;
+    int64_t lastFlush = 0;
+};
+
+#endif // TIME_WEIGHTED_DEPTH_H
@@ -31,21 +31,66 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 #include "nlohmann/json.hpp"
 #include "Logger.hpp"
+#include "RealTimeBar.hpp"
 
 using json = nlohmann::json;
 
+// One row of daily_data.
+struct DailyBar {
+    std::string date;
+    std::string symbol;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    double adjClose = 0.0;
+    double sma = 0.0;
+    double ema = 0.0;
+    double rsi = 0.0;
+    double macd = 0.0;
+    double vwap = 0.0;
+    double momentum = 0.0;
+};
+
+// Owns a bounded pool of connections. Every call checks one out for its own
+// transaction, so the real-time writer, the daily writer and the readers each
+// run on their own connection instead of queueing behind one another.
 class TimescaleDB {
 public:
-    TimescaleDB(const std::shared_ptr<Logger>& logger, const std::string &dbname, const std::string &user, const std::string &password, const std::string &host, const std::string &port);
+    struct PoolStats {
+        size_t size;
+        size_t inUse;
+        size_t highWater;
+        uint64_t checkouts;
+        uint64_t waits;              // checkouts that found no idle connection
+        double totalWaitMs;
+        double maxWaitMs;
+        double utilization;          // checked-out time / (size x time since start)
+        uint64_t reconnects;
+        uint64_t failedHealthChecks;
+    };
+
+    TimescaleDB(const std::shared_ptr<Logger>& logger, const std::string &dbname, const std::string &user, const std::string &password, const std::string &host, const std::string &port, size_t poolSize = 4);
     ~TimescaleDB();
     void stop();
     inline const bool isRunning() const { return running.load(); }
+    PoolStats getPoolStats() const;
 
-    bool insertRealTimeData(const std::string &datetime, const json &l1Data, const json &l2Data, const json &featureData);
+    // Group commit: the bars and their depth rows are streamed with COPY and merged in one
+    // transaction. Rows already stored are skipped, so a batch whose commit was lost in
+    // transit can simply be sent again.
+    bool insertRealTimeBars(const std::vector<RealTimeBar> &bars);
     bool insertOrUpdateDailyData(const std::string &date, const std::map<std::string, std::variant<double, std::string>> &dailyData);
+    // Streams the bars into a staging table with COPY and upserts them in one
+    // statement and one transaction. A later bar wins over an earlier one with the same date and symbol.
+    bool insertOrUpdateDailyBatch(const std::vector<DailyBar> &bars);
 
     const std::string getLastDailyEndDate(const std::string &symbol);
     const std::string getFirstDailyStartDate(const std::string &symbol);
@@ -53,21 +98,61 @@ public:
     std::vector<std::map<std::string, double>> getRecentHistoricalData(const std::string &symbol, int period);
 
 private:
+    // A connection checked out of the pool, returned when the lease is destroyed.
+    // A connection found closed on return is dropped and reopened by a later checkout.
+    class Lease {
+    public:
+        Lease(TimescaleDB& owner, size_t slot);
+        Lease(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        inline pqxx::connection& operator*() const { return *owner->slots[slot].conn; }
+        inline pqxx::connection* operator->() const { return owner->slots[slot].conn.get(); }
+
+    private:
+        TimescaleDB* owner;
+        size_t slot;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    struct Slot {
+        std::unique_ptr<pqxx::connection> conn;   // null until first checkout or after a failure
+    };
+
+    Lease acquire();
+    void release(size_t slot, std::chrono::steady_clock::time_point since);
+    std::unique_ptr<pqxx::connection> openConnection();
+    void checkPoolHealth();
+    void logPoolStats();
+
     void connectToDatabase();
     void createDatabase(const std::string &dbname, const std::string &user, const std::string &password, const std::string &host, const std::string &port);
-    void enableTimescaleExtension();
+    void enableTimescaleExtension(pqxx::connection& conn);
     void reconnect(int max_attempts, int delay_seconds);
-    void createTables();
+    void createTables(pqxx::connection& conn);
+    void prepareStatements(pqxx::connection& conn);
     void cleanupAndExit();
     void checkAndReconnect();
 
     std::shared_ptr<Logger> logger;
-    std::unique_ptr<pqxx::connection> conn;
     std::string dbname, user, password, host, port;
     std::atomic<bool> running;
     std::thread monitoringThread;
     std::mutex cvMutex;
     std::condition_variable cv;
+
+    // Slots are fixed at construction; `idle` is a stack, so the most recently used connection is reused first.
+    std::vector<Slot> slots;
+    std::vector<size_t> idle;
+    mutable std::mutex poolMutex;
+    std::condition_variable poolCV;
+    PoolStats stats{};
+    std::chrono::nanoseconds busyTime{0};
+    std::chrono::steady_clock::time_point poolStart;
 };
 
 #endif // TIMESCALEDB_H
\ No newline at end of file
@@ -0,0 +1,80 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef TOP_OF_BOOK_H
+#define TOP_OF_BOOK_H
+
+#include "FixedPoint.hpp"
+
+// Best bid and ask of one symbol, overwritten in place by the L1 BID / ASK /
+// BID_SIZE / ASK_SIZE ticks or by tick-by-tick BidAsk quotes.
+struct TopOfBook {
+    double bid = 0.0;
+    double ask = 0.0;
+    Quantity bidSize = 0;
+    Quantity askSize = 0;
+
+    // Both sides present and not locked or crossed.
+    inline bool valid() const { return bid > 0.0 && ask > bid; }
+    inline double spread() const { return ask - bid; }
+    inline double mid() const { return 0.5 * (bid + ask); }
+
+    // Size-weighted mid: leans towards the side with less resting size, which is
+    // the side more likely to be taken out next.
+    inline double microprice() const {
+        const double total = quantityToDouble(bidSize) + quantityToDouble(askSize);
+        if (total <= 0.0) return mid();
+        return (bid * quantityToDouble(askSize) + ask * quantityToDouble(bidSize)) / total;
+    }
+
+    // (bid size - ask size) / (bid size + ask size), in [-1, 1].
+    inline double imbalance() const {
+        const Quantity total = bidSize + askSize;
+        return total <= 0 ? 0.0 : static_cast<double>(bidSize - askSize) / static_cast<double>(total);
+    }
+};
+
+// Lee-Ready trade signing: a trade above the prevailing mid is buyer-initiated,
+// below it seller-initiated; at the mid (or without a two-sided quote) the tick
+// rule decides, carrying the last non-zero price change through zero ticks.
+class TradeSigner {
+public:
+    // Returns +1 (buy), -1 (sell) or 0 when nothing is known yet.
+    inline int classify(double price, const TopOfBook& quote) {
+        if (lastPrice > 0.0 && price != lastPrice) {
+            lastTick = price > lastPrice ? 1 : -1;
+        }
+        lastPrice = price;
+
+        if (quote.valid()) {
+            const double mid = quote.mid();
+            if (price > mid) return 1;
+            if (price < mid) return -1;
+        }
+        return lastTick;
+    }
+
+private:
+    double lastPrice = 0.0;
+    int lastTick = 0;
+};
+
+#endif // TOP_OF_BOOK_H
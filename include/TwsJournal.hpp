@@ -0,0 +1,106 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef TWS_JOURNAL_H
+#define TWS_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class EClientSocket;
+class EWrapper;
+class SimulatedClock;
+
+// Journal of the raw bytes received from TWS, one record per socket read:
+//
+//   header: char magic[4] = "STXJ", uint32 version, int64 start time (epoch ns)
+//   record: int64 offset from start (ns), uint32 size, `size` bytes
+//
+// Integers are stored in host byte order. The stream starts with the connect
+// handshake, so a replay needs nothing but the journal to decode it.
+constexpr char TWS_JOURNAL_MAGIC[4] = {'S', 'T', 'X', 'J'};
+constexpr uint32_t TWS_JOURNAL_VERSION = 1;
+
+// Tees every chunk received by one EClientSocket into a journal file.
+// attach() must be called before eConnect() to capture the handshake.
+class TwsJournalWriter {
+public:
+    explicit TwsJournalWriter(const std::string& path);
+    ~TwsJournalWriter();
+
+    TwsJournalWriter(const TwsJournalWriter&) = delete;
+    TwsJournalWriter& operator=(const TwsJournalWriter&) = delete;
+
+    // <prefix>_<YYYYmmdd-HHMMSS>.stxj in local time, so every connection gets its own file.
+    static std::string timestampedPath(const std::string& prefix);
+
+    void attach(EClientSocket& client);
+    void detach(EClientSocket& client);
+    void append(const char* data, int size);
+
+    inline uint64_t bytesWritten() const { return bytes.load(std::memory_order_relaxed); }
+
+private:
+    static void onReceive(void* context, const char* data, int size);
+
+    std::ofstream out;
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point startedAt;
+    std::atomic<uint64_t> bytes{0};
+};
+
+// Feeds a journal back through EDecoder into any EWrapper, as if it came from
+// a live socket. Only the length-prefixed (V100+) protocol is supported,
+// which is what every TWS/Gateway release this project targets speaks.
+class TwsJournalReplayer {
+public:
+    explicit TwsJournalReplayer(const std::string& path);
+
+    // speed: 1 replays at the recorded pace, 10 ten times faster, 0 as fast as possible.
+    // With a clock, time is advanced to each chunk's recorded time before it is
+    // decoded, so timers see the recorded timeline whatever the speed.
+    // Stops early once `running` turns false. Returns the number of messages decoded.
+    size_t replay(EWrapper* wrapper, double speed, const std::atomic<bool>& running, SimulatedClock* clock = nullptr) const;
+
+    // Wall time at which the capture started.
+    std::chrono::system_clock::time_point startTime() const;
+    inline size_t chunkCount() const { return chunks.size(); }
+    inline uint64_t byteCount() const { return bytes; }
+
+private:
+    struct Chunk {
+        int64_t offsetNs;
+        size_t begin;
+        size_t size;
+    };
+
+    std::vector<char> data;
+    std::vector<Chunk> chunks;
+    uint64_t bytes = 0;
+    int64_t startedAtNs = 0;
+};
+
+#endif // TWS_JOURNAL_H
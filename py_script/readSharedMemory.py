@@ -0,0 +1,111 @@
+"""Reader for the real-time bar rings published by RealTimeData.
+
+Mirrors include/SharedMemoryBars.hpp (schema version 1). Every (symbol,
+resolution) channel is a ring of fixed-size bar records guarded by a seqlock,
+so a reader copies the ring and retries when the writer touched it meanwhile.
+Resolution 0 channels carry intra-bar book snapshots stamped in epoch ms.
+"""
+
+import struct
+import time
+from multiprocessing import resource_tracker, shared_memory
+
+import pandas as pd
+
+SHM_MAGIC = 0x42585453  # "STXB"
+SHM_SCHEMA_VERSION = 1
+SNAPSHOT_RESOLUTION = 0
+
+HEADER = struct.Struct('<8IQQ16x')
+CHANNEL = struct.Struct('<16siIQQ24x')
+RECORD = struct.Struct('<q4dqQ3d2q8d')
+RECORD_FIELDS = ('timestamp', 'open', 'high', 'low', 'close', 'volume', 'trade_count', 'vwap',
+                 'best_bid', 'best_ask', 'bid_volume', 'ask_volume', 'buy_sell_ratio', 'implied_liquidity',
+                 'price_momentum', 'trade_density', 'rsi', 'macd', 'macd_signal', 'rolling_vwap')
+SCALED_FIELDS = ('volume', 'bid_volume', 'ask_volume')
+
+assert HEADER.size == 64 and CHANNEL.size == 64 and RECORD.size == 160
+
+
+class SharedMemoryBars:
+    def __init__(self, shm_name='RealTimeData'):
+        self.shm = shared_memory.SharedMemory(name=shm_name, create=False)
+        # The segment belongs to the C++ writer; do not unlink it when this process exits.
+        resource_tracker.unregister(self.shm._name, 'shared_memory')
+        self.buf = self.shm.buf
+
+        (magic, version, header_size, channel_size, record_size,
+         self.channel_count, self.ring_capacity, self.quantity_scale, _, _) = HEADER.unpack_from(self.buf, 0)
+        if magic != SHM_MAGIC:
+            raise RuntimeError('Shared memory segment has no real-time bar layout')
+        if (version != SHM_SCHEMA_VERSION or header_size != HEADER.size or
+                channel_size != CHANNEL.size or record_size != RECORD.size):
+            raise RuntimeError(f'Unsupported shared memory schema version {version}')
+
+        self.records_offset = HEADER.size + self.channel_count * CHANNEL.size
+
+    def close(self):
+        self.buf = None
+        self.shm.close()
+
+    def write_sequence(self):
+        return HEADER.unpack_from(self.buf, 0)[8]
+
+    def channels(self):
+        result = []
+        for i in range(self.channel_count):
+            symbol, resolution, _, _, _ = CHANNEL.unpack_from(self.buf, HEADER.size + i * CHANNEL.size)
+            result.append((symbol.rstrip(b'\0').decode(), resolution))
+        return result
+
+    def find_channel(self, symbol, resolution):
+        try:
+            return self.channels().index((symbol, resolution))
+        except ValueError:
+            return -1
+
+    def history(self, channel, max_records=None):
+        """Most recent records of a channel, oldest first, as a list of dicts."""
+        channel_offset = HEADER.size + channel * CHANNEL.size
+        ring_offset = self.records_offset + channel * self.ring_capacity * RECORD.size
+        limit = self.ring_capacity if max_records is None else min(max_records, self.ring_capacity)
+
+        while True:
+            _, _, _, before, count = CHANNEL.unpack_from(self.buf, channel_offset)
+            if before & 1:
+                time.sleep(0)
+                continue
+            available = min(count, limit)
+            rows = [RECORD.unpack_from(self.buf, ring_offset + ((count - available + i) % self.ring_capacity) * RECORD.size)
+                    for i in range(available)]
+            if CHANNEL.unpack_from(self.buf, channel_offset)[3] == before:
+                break
+
+        records = []
+        for row in rows:
+            record = dict(zip(RECORD_FIELDS, row))
+            for field in SCALED_FIELDS:
+                record[field] /= self.quantity_scale
+            records.append(record)
+        return records
+
+
+def read_shared_memory(shm_name, symbol, resolution, max_records=None):
+    """Bars of one symbol/resolution (seconds, 0 for book snapshots) as a DataFrame with the visualizer's columns."""
+    bars = SharedMemoryBars(shm_name)
+    try:
+        channel = bars.find_channel(symbol, resolution)
+        if channel < 0:
+            raise KeyError(f'{symbol} {resolution}s is not published in {shm_name}')
+        records = bars.history(channel, max_records)
+    finally:
+        bars.close()
+
+    df = pd.DataFrame.from_records(records, columns=RECORD_FIELDS)
+    unit = 'ms' if resolution == SNAPSHOT_RESOLUTION else 's'
+    df.insert(0, 'Datetime', pd.to_datetime(df['timestamp'], unit=unit))
+    return df.rename(columns={
+        'open': 'Open', 'high': 'High', 'low': 'Low', 'close': 'Close', 'volume': 'Volume',
+        'best_bid': 'BidPrice', 'bid_volume': 'BidSize', 'best_ask': 'AskPrice', 'ask_volume': 'AskSize',
+        'rsi': 'RSI', 'macd': 'MACD', 'macd_signal': 'MACDSignal', 'rolling_vwap': 'VWAP',
+    })
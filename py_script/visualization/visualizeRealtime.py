@@ -20,13 +20,14 @@ ax1.xaxis.set_major_formatter(mdates.DateFormatter('%H:%M'))
 
 # Shared memory settings
 SHM_NAME = 'RealTimeData'
-SHM_SIZE = 1024
+SYMBOL = 'SPY'
+RESOLUTION = 60  # seconds
 
 def update(frame):
     global ohlc_data, rsi_data, macd_data, depth_data
 
     # Read data from shared memory
-    df = read_shared_memory(SHM_NAME, SHM_SIZE)
+    df = read_shared_memory(SHM_NAME, SYMBOL, RESOLUTION)
     
     # Convert the 'Datetime' column to datetime objects
     df['Datetime'] = pd.to_datetime(df['Datetime'])
@@ -34,9 +35,7 @@ def update(frame):
     # Update OHLC data
     ohlc_data = df[['Datetime', 'Open', 'High', 'Low', 'Close', 'Volume']].values
     
-    # Update RSI and MACD (placeholder functions)
-    df['RSI'] = calculate_rsi(df['Close'])
-    df['MACD'] = calculate_macd(df['Close'])
+    # RSI and MACD are published alongside every bar
     rsi_data = df[['Datetime', 'RSI']].values
     macd_data = df[['Datetime', 'MACD']].values
 
@@ -77,23 +76,6 @@ def update(frame):
     snapshot_filename = f'data/analysis_pic/realtime_snapshot_{datetime.datetime.now().strftime("%Y%m%d%H%M%S")}.png'
     plt.savefig(snapshot_filename)
 
-# Placeholder functions for RSI and MACD
-def calculate_rsi(close_prices, period=14):
-    delta = close_prices.diff()
-    gain = (delta.where(delta > 0, 0)).rolling(window=period).mean()
-    loss = (-delta.where(delta < 0, 0)).rolling(window=period).mean()
-    rs = gain / loss
-    rsi = 100 - (100 / (1 + rs))
-    return rsi
-
-def calculate_macd(close_prices, short_period=12, long_period=26, signal_period=9):
-    short_ema = close_prices.ewm(span=short_period, adjust=False).mean()
-    long_ema = close_prices.ewm(span=long_period, adjust=False).mean()
-    macd_line = short_ema - long_ema
-    signal_line = macd_line.ewm(span=signal_period, adjust=False).mean()
-    macd_histogram = macd_line - signal_line
-    return macd_histogram
-
 # Create animation
 ani = FuncAnimation(fig, update, interval=60000)  # Update every minute
 
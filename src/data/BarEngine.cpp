@@ -0,0 +1,45 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <stdexcept>
+#include "BarEngine.hpp"
+
+BarEngine::BarEngine(const std::vector<int>& resolutionSeconds)
+    : resolutions(resolutionSeconds), builders(resolutionSeconds.size()) {
+    if (resolutions.empty()) {
+        throw std::invalid_argument("BarEngine needs at least one resolution");
+    }
+    for (size_t i = 0; i < resolutions.size(); ++i) {
+        if (resolutions[i] <= 0) {
+            throw std::invalid_argument("BarEngine resolutions must be positive");
+        }
+        if (i > 0 && (resolutions[i] <= resolutions[i - 1] || resolutions[i] % resolutions[i - 1] != 0)) {
+            throw std::invalid_argument("BarEngine resolution " + resolutionLabel(resolutions[i]) +
+                                        " is not a multiple of " + resolutionLabel(resolutions[i - 1]));
+        }
+    }
+}
+
+std::string resolutionLabel(int seconds) {
+    if (seconds % 3600 == 0) return std::to_string(seconds / 3600) + "h";
+    if (seconds % 60 == 0) return std::to_string(seconds / 60) + "m";
+    return std::to_string(seconds) + "s";
+}
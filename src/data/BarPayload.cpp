@@ -0,0 +1,85 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include "BarPayload.hpp"
+
+RealTimeBar barRow(const BarSeries& series, const BookFeatures* book) {
+    const OhlcvBar& bar = series.lastBar;
+    RealTimeBar row;
+    row.open = bar.open;
+    row.high = bar.high;
+    row.low = bar.low;
+    row.close = bar.close;
+    row.volume = quantityToDouble(bar.volume);
+    row.tradeCount = static_cast<int64_t>(bar.tradeCount);
+
+    row.weightedAvgPrice = bar.vwap();
+    if (book) {
+        row.buySellRatio = book->buySellRatio;
+        row.depthChange = quantityToDouble(book->depthChange);
+        row.impliedLiquidity = book->impliedLiquidity;
+    }
+    row.priceMomentum = series.momentum.value();
+    row.tradeDensity = series.tradeDensity.value();
+    row.rsi = series.rsi.value();
+    row.macd = series.macd.value();
+    row.vwap = series.vwap.value();
+
+    if (!series.ticks.empty()) {
+        row.tickTrades = static_cast<int64_t>(series.ticks.trades);
+        row.tickQuotes = static_cast<int64_t>(series.ticks.quotes);
+    }
+    if (!series.micro.empty()) {
+        row.spread = series.micro.meanSpread();
+        row.microprice = series.micro.microprice;
+        row.quoteImbalance = series.micro.meanImbalance();
+        row.orderFlowImbalance = series.micro.orderFlowImbalance();
+        row.signedVolume = quantityToDouble(series.micro.signedVolume());
+    }
+    return row;
+}
+
+std::vector<DepthLevel> depthRows(const DepthHistogram& depth) {
+    std::vector<DepthLevel> levels;
+    if (depth.empty() || depth.seconds <= 0.0) return levels;
+
+    const PriceLadder& ladder = depth.ladder();
+    for (int64_t bucket = depth.firstBucket(); bucket <= depth.lastBucket(); ++bucket) {
+        // Rounded to whole quantity units, as the sizes TWS sends.
+        const Quantity bid = doubleToQuantity(depth.bidSizeSeconds(bucket) / depth.seconds);
+        const Quantity ask = doubleToQuantity(depth.askSizeSeconds(bucket) / depth.seconds);
+        if (bid == 0 && ask == 0) continue;
+        levels.push_back({ladder.bucketPrice(bucket), quantityToDouble(bid), quantityToDouble(ask)});
+    }
+    return levels;
+}
+
+std::string utcTimestamp(int64_t epochSecond) {
+    const std::time_t time = static_cast<std::time_t>(epochSecond);
+    std::tm utc;
+    gmtime_r(&time, &utc);
+    std::ostringstream oss;
+    oss << std::put_time(&utc, "%Y-%m-%d %H:%M:%S") << "+00";
+    return oss.str();
+}
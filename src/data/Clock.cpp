@@ -0,0 +1,118 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+
+#include <algorithm>
+#include "Clock.hpp"
+
+namespace {
+
+inline int64_t toNs(Clock::TimePoint time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+inline Clock::TimePoint fromNs(int64_t ns) {
+    return Clock::TimePoint(std::chrono::duration_cast<Clock::TimePoint::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+Clock::TimePoint SystemClock::now() const {
+    return std::chrono::system_clock::now();
+}
+
+bool SystemClock::waitUntil(TimePoint deadline, std::chrono::nanoseconds realTimeout) {
+    TimePoint wakeUp = std::min(deadline, now() + std::chrono::duration_cast<TimePoint::duration>(realTimeout));
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_until(lock, wakeUp, [this] { return interrupted; });
+    return now() >= deadline;
+}
+
+void SystemClock::interrupt() {
+    std::lock_guard<std::mutex> lock(mutex);
+    interrupted = true;
+    cv.notify_all();
+}
+
+void SystemClock::resume() {
+    std::lock_guard<std::mutex> lock(mutex);
+    interrupted = false;
+}
+
+SimulatedClock::SimulatedClock(TimePoint start) : nowNs(toNs(start)) {}
+
+Clock::TimePoint SimulatedClock::now() const {
+    return fromNs(nowNs.load(std::memory_order_acquire));
+}
+
+bool SimulatedClock::waitUntil(TimePoint deadline, std::chrono::nanoseconds realTimeout) {
+    const int64_t deadlineNs = toNs(deadline);
+    std::unique_lock<std::mutex> lock(mutex);
+    auto entry = deadlines.insert(deadlineNs);
+    advanceCV.notify_all();
+
+    waiterCV.wait_for(lock, realTimeout, [this, deadlineNs] {
+        return interrupted || nowNs.load(std::memory_order_relaxed) >= deadlineNs;
+    });
+    // From here until the next waitUntil() the thread is busy and advanceTo() holds time still.
+    deadlines.erase(entry);
+    return nowNs.load(std::memory_order_relaxed) >= deadlineNs;
+}
+
+void SimulatedClock::interrupt() {
+    std::lock_guard<std::mutex> lock(mutex);
+    interrupted = true;
+    waiterCV.notify_all();
+    advanceCV.notify_all();
+}
+
+void SimulatedClock::resume() {
+    std::lock_guard<std::mutex> lock(mutex);
+    interrupted = false;
+}
+
+void SimulatedClock::attach() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++attached;
+}
+
+void SimulatedClock::detach() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (attached > 0) --attached;
+    advanceCV.notify_all();
+}
+
+bool SimulatedClock::idle() const {
+    if (interrupted) return true;
+    return deadlines.size() >= attached && (deadlines.empty() || *deadlines.begin() > nowNs.load(std::memory_order_relaxed));
+}
+
+void SimulatedClock::advanceTo(TimePoint time) {
+    const int64_t timeNs = toNs(time);
+    std::unique_lock<std::mutex> lock(mutex);
+    // Work started at the current time finishes before time moves on.
+    advanceCV.wait(lock, [this] { return idle(); });
+    if (timeNs <= nowNs.load(std::memory_order_relaxed)) return;
+
+    nowNs.store(timeNs, std::memory_order_release);
+    waiterCV.notify_all();
+    advanceCV.wait(lock, [this] { return idle(); });
+}
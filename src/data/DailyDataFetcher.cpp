@@ -34,6 +34,33 @@
 constexpr const char* IB_HOST = "127.0.0.1";
 constexpr int IB_PORT = 7496;
 constexpr int IB_CLIENT_ID = 2;
+constexpr size_t DAILY_BATCH_SIZE = 500;
+constexpr int DAILY_FLUSH_INTERVAL_MS = 1000;
+constexpr int DAILY_SHUTDOWN_ATTEMPTS = 3;       // failed writes tolerated after stop() before queued bars are dropped
+
+namespace {
+
+DailyBar toDailyBar(const DataItem& item) {
+    auto field = [&item](const char* name) { return std::get<double>(item.data.at(name)); };
+    DailyBar bar;
+    bar.date = item.date;
+    bar.symbol = std::get<std::string>(item.data.at("symbol"));
+    bar.open = field("open");
+    bar.high = field("high");
+    bar.low = field("low");
+    bar.close = field("close");
+    bar.volume = field("volume");
+    bar.adjClose = field("adj_close");
+    bar.sma = field("sma");
+    bar.ema = field("ema");
+    bar.rsi = field("rsi");
+    bar.macd = field("macd");
+    bar.vwap = field("vwap");
+    bar.momentum = field("momentum");
+    return bar;
+}
+
+} // namespace
 
 DailyDataFetcher::DailyDataFetcher(const std::shared_ptr<Logger>& logger, const std::shared_ptr<TimescaleDB>& _db)
     : logger(logger), db(_db), 
@@ -68,7 +95,10 @@ bool DailyDataFetcher::connectToIB(int maxRetries, int retryDelayMs) {
             if (!osSignal) osSignal = std::make_unique<EReaderOSSignal>(2000);
             if (!osSignal) throw std::runtime_error("Failed to create EReaderOSSignal");
 
-            if (!client) client = std::make_unique<EClientSocket>(this, osSignal.get());
+            if (!client) {
+                client = std::make_unique<EClientSocket>(this, osSignal.get());
+                if (!journalPath.empty()) openJournal();
+            }
             if (!client) throw std::runtime_error("Failed to create EClientSocket");
 
             if (!client->eConnect(IB_HOST, IB_PORT, IB_CLIENT_ID, false)) {
@@ -169,6 +199,11 @@ void DailyDataFetcher::stop() {
         STX_LOGW(logger, "client was already nullptr.");
     }
 
+    if (journal) {
+        STX_LOGI(logger, "TWS journal closed after " + std::to_string(journal->bytesWritten()) + " bytes.");
+        journal.reset();
+    }
+
     if (reader) {
         reader->stop();
         STX_LOGI(logger, "reader stopped successfully.");
@@ -279,6 +314,56 @@ bool DailyDataFetcher::fetchAndProcessDailyData(const std::string& symbol, const
     return true;
 }
 
+void DailyDataFetcher::openJournal() {
+    std::string path = TwsJournalWriter::timestampedPath(journalPath);
+    try {
+        journal = std::make_unique<TwsJournalWriter>(path);
+        journal->attach(*client);
+        STX_LOGI(logger, "Capturing TWS stream into " + path);
+    } catch (const std::exception& e) {
+        STX_LOGE(logger, "TWS journal disabled: " + std::string(e.what()));
+    }
+}
+
+bool DailyDataFetcher::replay(const std::string& symbol, const std::string& journalFile, double speed) {
+    std::unique_lock<std::mutex> clientLock(clientMutex);
+    if (running.load()) {
+        STX_LOGW(logger, "DailyDataFetcher is already running, cannot replay " + journalFile);
+        return false;
+    }
+    running.store(true);
+    clientLock.unlock();
+
+    try {
+        TwsJournalReplayer replayer(journalFile);
+        STX_LOGI(logger, "Replaying " + journalFile + " for " + symbol + ": " + std::to_string(replayer.chunkCount()) + " chunks, " +
+                 std::to_string(replayer.byteCount()) + " bytes.");
+
+        if (databaseThread.joinable()) {
+            databaseThread.join();
+        }
+        databaseThread = std::thread(&DailyDataFetcher::writeToDatabaseFunc, this);
+#ifndef __TEST__
+        initializeIndicatorData(symbol, maxPeriod);
+#endif
+
+        // The journal carries no request context, so every bar is attributed to `symbol`.
+        size_t messages = replayer.replay(this, speed, running);
+        for (const auto& data : historicalDataBuffer) {
+            storeDailyData(symbol, data);
+        }
+        STX_LOGI(logger, "Replayed " + std::to_string(messages) + " messages, " + std::to_string(historicalDataBuffer.size()) + " bars.");
+        historicalDataBuffer.clear();
+    } catch (const std::exception& e) {
+        STX_LOGE(logger, "Exception in replay: " + std::string(e.what()));
+        stop();
+        return false;
+    }
+
+    stop();
+    return true;
+}
+
 bool DailyDataFetcher::requestDailyData(const std::string& symbol, const std::string& startDate, const std::string& endDate, const std::string& barSize) {
     if (!client || !client->isConnected()) {
         STX_LOGE(logger, "Not connected to IB TWS. Cannot request historical data.");
@@ -480,12 +565,15 @@ void DailyDataFetcher::storeDailyData(const std::string& symbol, const std::map<
     // Use adj_close if provided, otherwise use close
     double adjClose = (historicalData.find("adj_close") != historicalData.end()) ? std::get<double>(historicalData.at("adj_close")) : close;
 
-    if (std::get<double>(dbData["sma"]) == 0.0) dbData["sma"] = calculateSMA(symbol, adjClose);
-    if (std::get<double>(dbData["ema"]) == 0.0) dbData["ema"] = calculateEMA(symbol, adjClose);
-    if (std::get<double>(dbData["rsi"]) == 0.0) dbData["rsi"] = calculateRSI(symbol, adjClose);
-    if (std::get<double>(dbData["macd"]) == 0.0) dbData["macd"] = calculateMACD(symbol, adjClose);
-    if (std::get<double>(dbData["vwap"]) == 0.0) dbData["vwap"] = calculateVWAP(symbol, volume, adjClose);
-    if (std::get<double>(dbData["momentum"]) == 0.0) dbData["momentum"] = calculateMomentum(symbol, adjClose);
+    DailyIndicators& symbolIndicators = indicators[symbol];
+    symbolIndicators.update(adjClose, volume);
+
+    if (std::get<double>(dbData["sma"]) == 0.0) dbData["sma"] = symbolIndicators.sma.ready() ? symbolIndicators.sma.value() : adjClose;
+    if (std::get<double>(dbData["ema"]) == 0.0) dbData["ema"] = symbolIndicators.ema.value();
+    if (std::get<double>(dbData["rsi"]) == 0.0) dbData["rsi"] = symbolIndicators.rsi.value();
+    if (std::get<double>(dbData["macd"]) == 0.0) dbData["macd"] = symbolIndicators.macd.value();
+    if (std::get<double>(dbData["vwap"]) == 0.0) dbData["vwap"] = symbolIndicators.vwap.value();
+    if (std::get<double>(dbData["momentum"]) == 0.0) dbData["momentum"] = symbolIndicators.momentum.ready() ? symbolIndicators.momentum.value() : 0.0;
 
     if (std::get<double>(dbData["adj_close"]) == 0.0) dbData["adj_close"] = adjClose;
 
@@ -653,95 +741,6 @@ std::string DailyDataFetcher::getNextDay(const std::string& date) {
     return oss.str();
 }
 
-// Helper functions: Calculate SMA, EMA, RSI, MACD, VWAP, Momentum
-double DailyDataFetcher::calculateSMA(const std::string& symbol, double close, int period) {
-    closingPrices[symbol].push_back(close);
-
-    while (closingPrices[symbol].size() > period) {
-        closingPrices[symbol].pop_front();
-    }
-
-    if (closingPrices[symbol].size() < period) {
-        return close;
-    }
-
-    double sum = std::accumulate(closingPrices[symbol].begin(), closingPrices[symbol].end(), 0.0);
-    return sum / period;
-}
-
-double DailyDataFetcher::calculateEMA(const std::string& symbol, double close, int period) {
-    double multiplier = 2.0 / (period + 1);
-
-    if (emaDataPoints[symbol] < period) {
-        return calculateSMA(symbol, close, period);
-    } else {
-        emaValues[symbol] = (close - emaValues[symbol]) * multiplier + emaValues[symbol];
-        emaDataPoints[symbol]++;
-    }
-
-    return emaValues[symbol];
-}
-
-double DailyDataFetcher::calculateRSI(const std::string& symbol, double close, int period) {
-    if (lastClose.find(symbol) == lastClose.end()) {
-        lastClose[symbol] = close;
-        return 50.0;  // Default to neutral RSI if it's the first data point
-    }
-
-    double change = close - lastClose[symbol];
-    lastClose[symbol] = close;
-
-    gains[symbol].push_back(std::max(change, 0.0));
-    losses[symbol].push_back(std::max(-change, 0.0));
-
-    if (gains[symbol].size() > period) {
-        gains[symbol].pop_front();
-        losses[symbol].pop_front();
-    }
-
-    if (gains[symbol].size() < period) {
-        return 50.0;  // Not enough data, return neutral RSI
-    }
-
-    double avgGain = std::accumulate(gains[symbol].begin(), gains[symbol].end(), 0.0) / period;
-    double avgLoss = std::accumulate(losses[symbol].begin(), losses[symbol].end(), 0.0) / period;
-
-    if (avgLoss == 0.0) return 100.0;
-
-    double rs = avgGain / avgLoss;
-    return 100.0 - (100.0 / (1.0 + rs));
-}
-
-double DailyDataFetcher::calculateMACD(const std::string& symbol, double close) {
-    const int shortPeriod = 12;
-    const int longPeriod = 26;
-
-    double shortEMA = calculateEMA(symbol, close, shortPeriod);
-    double longEMA = calculateEMA(symbol, close, longPeriod);
-
-    return shortEMA - longEMA;
-}
-
-double DailyDataFetcher::calculateVWAP(const std::string& symbol, double volume, double close) {
-    cumulativePriceVolume[symbol] += close * volume;
-    cumulativeVolume[symbol] += volume;
-
-    if (cumulativeVolume[symbol] == 0) {
-        return close;  // Avoid division by zero
-    }
-
-    return cumulativePriceVolume[symbol] / cumulativeVolume[symbol];
-}
-
-double DailyDataFetcher::calculateMomentum(const std::string& symbol, double close, int period) {
-
-    if (closingPrices[symbol].size() < period) {
-        return 0.0;
-    }
-
-    return close - closingPrices[symbol].front();
-}
-
 void DailyDataFetcher::addToQueue(const std::string& date, const std::map<std::string, std::variant<double, std::string>>& historicalData) {
     DataItem item;
     item.date = date;
@@ -754,42 +753,67 @@ void DailyDataFetcher::addToQueue(const std::string& date, const std::map<std::s
     queueCV.notify_one();
 }
 
+// Writes the queue in batches of up to DAILY_BATCH_SIZE bars, one COPY and one
+// commit each. A backfill fills a batch quickly; a trickle is flushed after
+// DAILY_FLUSH_INTERVAL_MS, and stop() flushes whatever is left at once. After
+// stop() a failing database gets DAILY_SHUTDOWN_ATTEMPTS more tries before the
+// queue is dropped, so shutdown cannot hang on a database that is down.
 void DailyDataFetcher::writeToDatabaseFunc() {
     try {
         STX_LOGI(logger, "writeToDatabaseThread started.");
-        while (running.load() || !dataQueue.empty()) {
+        std::vector<DataItem> batch;
+        std::vector<DailyBar> bars;
+#ifndef __TEST__
+        int shutdownFailures = 0;
+#endif
+        while (true) {
             std::unique_lock<std::mutex> lock(queueMutex);
             if (!queueCV.wait_for(lock, std::chrono::seconds(10), [this] { return !dataQueue.empty() || !running.load(); })) {
                 STX_LOGW(logger, "writeToDatabaseFunc wait timed out.");
                 continue;
             }
+            if (!running.load() && dataQueue.empty()) break;
+            queueCV.wait_for(lock, std::chrono::milliseconds(DAILY_FLUSH_INTERVAL_MS), [this] { return dataQueue.size() >= DAILY_BATCH_SIZE || !running.load(); });
 
-            while (!dataQueue.empty()) {
-                DataItem item = dataQueue.top();
+            batch.clear();
+            while (!dataQueue.empty() && batch.size() < DAILY_BATCH_SIZE) {
+                batch.push_back(dataQueue.top());
                 dataQueue.pop();
-                lock.unlock(); // Unlock before database operations
+            }
+            lock.unlock(); // Unlock before database operations
+            if (batch.empty()) continue;
 #ifndef __TEST__
-                try {
-                    // Insert into database
-                    if (db->insertOrUpdateDailyData(item.date, item.data)) {
-                        STX_LOGI(logger, std::get<std::string>(item.data.at("symbol")) + "-" + item.date + " has been written into db.");
-                    } else {
-                        STX_LOGE(logger, "Failed to write data to db: " + std::get<std::string>(item.data.at("symbol")) + " " + item.date + ", will retry ...");
-                        // Reinsert the item for retry
-                        storeDailyData(std::get<std::string>(item.data.at("symbol")), item.data);
-                        break; // Exit the loop to retry later
-                    }
-                } catch (const std::exception& e) {
-                    STX_LOGE(logger, "Exception while writing to DB: " + std::string(e.what()));
-                    // Reinsert the item for retry
-                    storeDailyData(std::get<std::string>(item.data.at("symbol")), item.data);
-                    break; // Exit the loop to retry later
+            bool stored = false;
+            try {
+                bars.clear();
+                for (const DataItem& item : batch) {
+                    bars.push_back(toDailyBar(item));
                 }
+                stored = db->insertOrUpdateDailyBatch(bars);
+            } catch (const std::exception& e) {
+                STX_LOGE(logger, "Exception while writing to DB: " + std::string(e.what()));
+            }
+            if (stored) {
+                STX_LOGI(logger, std::to_string(batch.size()) + " daily bars from " + batch.front().date + " to " + batch.back().date + " have been written into db.");
+            } else if (!running.load() && ++shutdownFailures >= DAILY_SHUTDOWN_ATTEMPTS) {
+                size_t dropped = batch.size();
+                lock.lock();
+                dropped += dataQueue.size();
+                dataQueue = decltype(dataQueue)();
+                lock.unlock();
+                STX_LOGE(logger, "Database still failing after stop, dropped " + std::to_string(dropped) + " unwritten daily bars.");
+                break;
+            } else {
+                STX_LOGE(logger, "Failed to write " + std::to_string(batch.size()) + " daily bars to db, will retry ...");
+                // Requeue the bars as they are; their indicators are already computed.
+                for (const DataItem& item : batch) {
+                    addToQueue(item.date, item.data);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(DAILY_FLUSH_INTERVAL_MS));
+            }
 #else
-                STX_LOGI(logger, "Simulated writeToDatabaseFunc: " + item.date + " has been written into db.");
+            STX_LOGI(logger, "Simulated writeToDatabaseFunc: " + std::to_string(batch.size()) + " daily bars have been written into db.");
 #endif
-                lock.lock(); // Re-lock for the next iteration
-            }
         }
         STX_LOGI(logger, "writeToDatabaseThread exiting gracefully.");
     } catch (const std::exception& e) {
@@ -828,41 +852,9 @@ void DailyDataFetcher::initializeIndicatorData(const std::string& symbol, int pe
         return;
     }
 
-    // Initialize closingPrices and related variables
+    // Replay the stored closes through a fresh indicator state, oldest first
+    DailyIndicators& symbolIndicators = indicators[symbol] = DailyIndicators();
     for (const auto& data : historicalData) {
-        double close = data.at("close");
-        closingPrices[symbol].push_back(close);
-
-        if (closingPrices[symbol].size() > period) {
-            closingPrices[symbol].pop_front();
-        }
-
-        // Initialize EMA values
-        if (emaDataPoints[symbol] == 0) {
-            emaValues[symbol] = close;
-            emaDataPoints[symbol] = 1;
-        } else {
-            double multiplier = 2.0 / (period + 1);
-            emaValues[symbol] = (close - emaValues[symbol]) * multiplier + emaValues[symbol];
-            emaDataPoints[symbol]++;
-        }
-
-        // Initialize gains and losses for RSI
-        if (lastClose.find(symbol) != lastClose.end()) {
-            double change = close - lastClose[symbol];
-            gains[symbol].push_back(std::max(change, 0.0));
-            losses[symbol].push_back(std::max(-change, 0.0));
-
-            if (gains[symbol].size() > period) {
-                gains[symbol].pop_front();
-                losses[symbol].pop_front();
-            }
-        }
-        lastClose[symbol] = close;
-
-        // Initialize cumulative volumes for VWAP
-        double volume = data.at("volume");
-        cumulativePriceVolume[symbol] += close * volume;
-        cumulativeVolume[symbol] += volume;
+        symbolIndicators.update(data.at("close"), data.at("volume"));
     }
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include "FeatureKernel.hpp"
+
+BookFeatures computeBookFeatures(const OrderBook& book) {
+    BookFeatures features;
+    features.bidVolume = book.volume(BookSide::Bid);
+    features.askVolume = book.volume(BookSide::Ask);
+
+    const int bidDepth = book.depth(BookSide::Bid);
+    const int askDepth = book.depth(BookSide::Ask);
+    const double bidVolume = quantityToDouble(features.bidVolume);
+    const double askVolume = quantityToDouble(features.askVolume);
+
+    features.buySellRatio = askVolume == 0.0 ? 0.0 : bidVolume / askVolume;
+    features.depthChange = features.bidVolume - features.askVolume;
+
+    const double spread = book.bestAsk() - book.bestBid();
+    if (bidDepth > 0 && askDepth > 0 && spread > 0) {
+        features.impliedLiquidity = (bidVolume / bidDepth + askVolume / askDepth) / spread;
+    }
+
+    return features;
+}
+
+void accumulateTickFeatures(TickFeatures& features, const TickEvent* events, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const TickEvent& event = events[i];
+        switch (event.kind()) {
+            case TickKind::Trade:
+                ++features.trades;
+                if (event.size != UNSET_QUANTITY) features.tradeVolume += event.size;
+                break;
+            case TickKind::Bid:
+            case TickKind::Ask:
+                ++features.quotes;
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <algorithm>
+#include "OrderBook.hpp"
+
+OrderBook::OrderBook() {
+    clear();
+}
+
+void OrderBook::clear() {
+    for (auto& side : levels) {
+        side.prices.fill(0.0);
+        side.sizes.fill(0);
+        side.depth = 0;
+        side.total = 0;
+    }
+}
+
+bool OrderBook::apply(int position, int operation, int side, double price, Quantity size) {
+    if (position < 0 || position >= MAX_DEPTH || (side != 0 && side != 1)) {
+        return false;
+    }
+    // TWS may send UNSET_DECIMAL; an unknown size must not reach the running total.
+    if (size == UNSET_QUANTITY) size = 0;
+
+    Levels& levelsForSide = levels[side];
+    switch (static_cast<BookOperation>(operation)) {
+        case BookOperation::Insert:
+            insert(levelsForSide, position, price, size);
+            return true;
+        case BookOperation::Update:
+            update(levelsForSide, position, price, size);
+            return true;
+        case BookOperation::Delete:
+            remove(levelsForSide, position);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void OrderBook::insert(Levels& side, int position, double price, Quantity size) {
+    position = std::min(position, side.depth);
+    int last = std::min(side.depth, MAX_DEPTH - 1);
+    // A full side pushes its last row out.
+    if (side.depth == MAX_DEPTH) side.total -= side.sizes[MAX_DEPTH - 1];
+
+    std::copy_backward(side.prices.begin() + position, side.prices.begin() + last, side.prices.begin() + last + 1);
+    std::copy_backward(side.sizes.begin() + position, side.sizes.begin() + last, side.sizes.begin() + last + 1);
+
+    side.prices[position] = price;
+    side.sizes[position] = size;
+    side.depth = std::min(side.depth + 1, MAX_DEPTH);
+    side.total += size;
+}
+
+void OrderBook::update(Levels& side, int position, double price, Quantity size) {
+    // TWS occasionally updates the row just past the current depth; treat it as an append.
+    if (position >= side.depth) {
+        insert(side, side.depth, price, size);
+        return;
+    }
+    side.total += size - side.sizes[position];
+    side.prices[position] = price;
+    side.sizes[position] = size;
+}
+
+void OrderBook::remove(Levels& side, int position) {
+    if (position >= side.depth) return;
+
+    side.total -= side.sizes[position];
+    std::copy(side.prices.begin() + position + 1, side.prices.begin() + side.depth, side.prices.begin() + position);
+    std::copy(side.sizes.begin() + position + 1, side.sizes.begin() + side.depth, side.sizes.begin() + position);
+
+    --side.depth;
+    side.prices[side.depth] = 0.0;
+    side.sizes[side.depth] = 0;
+}
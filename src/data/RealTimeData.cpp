@@ -24,36 +24,60 @@
 #include <numeric>
 #include <thread>
 #include <chrono>
-#include <future>
 #include <boost/circular_buffer.hpp>
 #include "RealTimeData.hpp"
 
-using json = nlohmann::json;
 
 constexpr const char* IB_HOST = "127.0.0.1";
 constexpr int IB_PORT = 7496;
 constexpr int IB_CLIENT_ID = 0;
 constexpr const char* SHARED_MEMORY_NAME = "RealTimeData";
-constexpr size_t SHARED_MEMORY_SIZE = 4096;
-
-RealTimeData::RealTimeData(const std::shared_ptr<Logger>& log, const std::shared_ptr<TimescaleDB>& _db)
-    : logger(log), db(_db), 
+constexpr int MARKET_DEPTH_ROWS = 60;
+constexpr int REQUEST_PACING_MS = 50;
+constexpr size_t L1_RING_CAPACITY = 4096;
+constexpr size_t L2_RING_CAPACITY = 8192;
+constexpr size_t TICK_RING_CAPACITY = 8192;
+constexpr int RING_DRAIN_INTERVAL_MS = 10;
+constexpr int DB_SHUTDOWN_ATTEMPTS = 3;          // failed writes tolerated after stop() before queued rows are dropped
+
+RealTimeData::RealTimeData(const std::shared_ptr<Logger>& log, const std::shared_ptr<TimescaleDB>& _db, const RealTimeConfig& _config)
+    : logger(log), db(_db), config(_config),
       osSignal(nullptr), 
       client(nullptr), 
       reader(nullptr),
       nextOrderId(0), 
-      requestId(0), 
-      running(false){
+      running(false),
+      clock(std::make_shared<SystemClock>()) {
 
     if (!logger) {
         throw std::runtime_error("Loggeris null");
     }
-#ifndef __TEST__
-    if (!db) {
-        throw std::runtime_error("TimescaleDB is null");
+    if (config.symbols.empty()) {
+        throw std::runtime_error("Real-time symbol universe is empty");
     }
-#endif
-    STX_LOGI(logger, "RealTimeData object created successfully.");
+    if (config.barResolutions.empty()) {
+        throw std::runtime_error("No real-time bar resolutions configured");
+    }
+
+    const PriceLadder ladder{config.depthTickSize, config.depthBucketTicks, config.depthLadderBuckets};
+    for (size_t i = 0; i < config.symbols.size(); ++i) {
+        auto state = std::make_unique<SymbolState>(L1_RING_CAPACITY, L2_RING_CAPACITY, TICK_RING_CAPACITY, config.barResolutions);
+        state->index = i;
+        state->contract = createContract(config.symbols[i].symbol, "STK", config.symbols[i].exchange, "USD");
+        state->depth = TimeWeightedDepth(ladder);
+        for (int seconds : config.barResolutions) {
+            BarSeries series;
+            series.seconds = seconds;
+            series.persist = std::find(config.databaseResolutions.begin(), config.databaseResolutions.end(), seconds) != config.databaseResolutions.end();
+            series.depth = DepthHistogram(ladder);
+            state->series.push_back(std::move(series));
+        }
+        symbolStates.push_back(std::move(state));
+    }
+    initializeShards();
+    buildTaskGraphs();
+
+    STX_LOGI(logger, "RealTimeData object created successfully for " + std::to_string(symbolStates.size()) + " symbols on " + std::to_string(shards.size()) + " shards.");
 }
 
 RealTimeData::~RealTimeData() {
@@ -70,7 +94,10 @@ bool RealTimeData::connectToIB(int maxRetries, int retryDelayMs) {
             if (!osSignal) osSignal = std::make_unique<EReaderOSSignal>(2000);
             if (!osSignal) throw std::runtime_error("Failed to create EReaderOSSignal");
 
-            if (!client) client = std::make_unique<EClientSocket>(this, osSignal.get());
+            if (!client) {
+                client = std::make_unique<EClientSocket>(this, osSignal.get());
+                if (!journalPath.empty()) openJournal();
+            }
             if (!client) throw std::runtime_error("Failed to create EClientSocket");
 
             if (!client->eConnect(IB_HOST, IB_PORT, IB_CLIENT_ID, false)) {
@@ -130,6 +157,10 @@ bool RealTimeData::start() {
         clientLock.unlock();
         return true;
     }
+    if (!hasRowStore()) {
+        clientLock.unlock();
+        return false;
+    }
     STX_LOGI(logger, "Starting RealTimeData collection...");
     running.store(true);
     clientLock.unlock();
@@ -141,26 +172,71 @@ bool RealTimeData::start() {
     }
 
     try {
-        initializeSharedMemory();
+        startPipeline();
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         requestData();
-
-        processDataThread = std::thread(&RealTimeData::processData, this);
+        clock->attach();
         monitorDataFlowThread = std::thread(&RealTimeData::monitorDataFlow, this, 3, 1000, 5000);
-        databaseThread = std::thread(&RealTimeData::writeToDatabaseFunc, this);
 
         STX_LOGI(logger, "RealTimeData collection started successfully.");
         return true;
     } catch (const std::exception &e) {
         STX_LOGE(logger, "Exception in start: " + std::string(e.what()));
-        clientLock.lock();
-        running.store(false);
-        clientLock.unlock();
+        stop();
         return false;
     }
     return false;
 }
 
+bool RealTimeData::startOffline() {
+    std::unique_lock<std::mutex> clientLock(clientMutex);
+    if (running.load()) {
+        STX_LOGW(logger, "RealTimeData is already running.");
+        return false;
+    }
+    if (!hasRowStore()) return false;
+    running.store(true);
+    clientLock.unlock();
+
+    try {
+        startPipeline();
+        STX_LOGI(logger, "RealTimeData pipeline started without a TWS connection.");
+        return true;
+    } catch (const std::exception &e) {
+        STX_LOGE(logger, "Exception in startOffline: " + std::string(e.what()));
+        stop();
+        return false;
+    }
+}
+
+bool RealTimeData::hasRowStore() const {
+#ifndef __TEST__
+    if (!db && !rowSink) {
+        STX_LOGE(logger, "TimescaleDB is null and no row sink is set.");
+        return false;
+    }
+#endif
+    return true;
+}
+
+void RealTimeData::startPipeline() {
+    initializeSharedMemory();
+    if (!workers) {
+        // Kept across stop()/start(), so a reconnect does not create threads either.
+        workers = std::make_unique<ThreadPool>(config.workers, config.workerCpus);
+        STX_LOGI(logger, "Aggregation pool started with " + std::to_string(workers->size()) + " workers, " + std::to_string(workers->pinned()) + " pinned.");
+        if (workers->pinned() < config.workerCpus.size()) {
+            STX_LOGW(logger, "Could not pin every aggregation worker to its CPU; the OS places the rest.");
+        }
+    }
+    clock->resume();
+    // Attached before the thread exists so a simulated clock cannot move ahead of it.
+    // The pool workers only run inside a graph run the pipeline thread waits for, so they need no attach.
+    clock->attach();
+    pipelineThread = std::thread(&RealTimeData::runPipeline, this);
+    databaseThread = std::thread(&RealTimeData::writeToDatabaseFunc, this);
+}
+
 void RealTimeData::stop() {
     if (!running.load()) {
         STX_LOGW(logger, "RealTimeData is already stopped.");
@@ -170,9 +246,10 @@ void RealTimeData::stop() {
     running.store(false);
 
     // Notify all threads to exit immediately
+    clock->interrupt();
     {
-        std::lock_guard<std::mutex> lock(cvMutex);
-        cv.notify_all();
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queueCV.notify_all();
     }
     
     if (client && client->isConnected()) {
@@ -182,6 +259,7 @@ void RealTimeData::stop() {
 
     joinThreads();
 
+    sharedMemoryWriter.reset();
     boost::interprocess::shared_memory_object::remove(SHARED_MEMORY_NAME);
     STX_LOGI(logger, "shared memory removed sussessfully.");
 
@@ -191,6 +269,11 @@ void RealTimeData::stop() {
     } else {
         STX_LOGW(logger, "client was already nullptr.");
     }
+
+    if (journal) {
+        STX_LOGI(logger, "TWS journal closed after " + std::to_string(journal->bytesWritten()) + " bytes.");
+        journal.reset();
+    }
     
     if (reader) {
         reader->stop();
@@ -209,35 +292,93 @@ void RealTimeData::stop() {
     STX_LOGI(logger, "RealTimeData stopped and cleaned up.");
 }
 
-void RealTimeData::requestData(int maxRetries, int retryDelayMs) {
-    Contract contract = createContract("SPY", "STK", "ARCA", "USD");
-    STX_LOGD(logger, "Created contract: Symbol=" + contract.symbol + ", SecType=" + contract.secType + ", Exchange=" + contract.exchange + ", Currency=" + contract.currency);
+void RealTimeData::openJournal() {
+    std::string path = TwsJournalWriter::timestampedPath(journalPath);
+    try {
+        journal = std::make_unique<TwsJournalWriter>(path);
+        journal->attach(*client);
+        STX_LOGI(logger, "Capturing TWS stream into " + path);
+    } catch (const std::exception& e) {
+        STX_LOGE(logger, "TWS journal disabled: " + std::string(e.what()));
+    }
+}
 
-    for (int attempt = 0; attempt < maxRetries; ++attempt) {
-        try {
-            int l1RequestId, l2RequestId;
-            {
-                std::unique_lock<std::mutex> clientLock(clientMutex, std::defer_lock);
-                clientLock.lock();
-                l1RequestId = ++requestId;
-                l2RequestId = ++requestId;
-                clientLock.unlock();
-            } // Release the mutex here
+bool RealTimeData::replay(const std::string& journalFile, double speed) {
+    std::unique_ptr<TwsJournalReplayer> replayer;
+    try {
+        replayer = std::make_unique<TwsJournalReplayer>(journalFile);
+    } catch (const std::exception &e) {
+        STX_LOGE(logger, "Exception in replay: " + std::string(e.what()));
+        return false;
+    }
+    if (running.load()) {
+        STX_LOGW(logger, "RealTimeData is already running, cannot replay " + journalFile);
+        return false;
+    }
 
-            std::thread l1Thread(&RealTimeData::requestL1Data, this, l1RequestId, std::ref(contract));
-            std::thread l2Thread(&RealTimeData::requestL2Data, this, l2RequestId, std::ref(contract));
+    // Bars close on the recorded timeline, driven by the journal timestamps rather than wall time.
+    std::shared_ptr<Clock> wallClock = clock;
+    auto replayClock = std::make_shared<SimulatedClock>(replayer->startTime());
+    clock = replayClock;
+    if (!startOffline()) {
+        clock = wallClock;
+        STX_LOGW(logger, "Cannot replay " + journalFile);
+        return false;
+    }
+    STX_LOGI(logger, "Replaying " + journalFile + ": " + std::to_string(replayer->chunkCount()) + " chunks, " +
+             std::to_string(replayer->byteCount()) + " bytes, speed " + (speed > 0.0 ? std::to_string(speed) + "x" : std::string("max")));
 
-            l1Thread.join();
-            l2Thread.join();
+    bool replayed = true;
+    try {
+        // Ticker ids are derived from the symbol order, so the journal must come from the same universe.
+        auto replayStart = std::chrono::steady_clock::now();
+        size_t messages = replayer->replay(this, speed, running, replayClock.get());
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replayStart).count();
+        STX_LOGI(logger, "Replayed " + std::to_string(messages) + " messages in " + std::to_string(elapsedMs) + " ms.");
+
+        // One more second boundary closes the last bars.
+        replayClock->advanceBy(std::chrono::seconds(1));
+    } catch (const std::exception &e) {
+        STX_LOGE(logger, "Exception in replay: " + std::string(e.what()));
+        replayed = false;
+    }
 
-            return;
-        } catch (const std::exception &e) {
-            STX_LOGE(logger, "Error during requestData: " + std::string(e.what()));
-            if (attempt < maxRetries - 1) {
-                STX_LOGW(logger, "Retrying data request in " + std::to_string(retryDelayMs) + "ms...");
-                std::this_thread::sleep_for(std::chrono::milliseconds(retryDelayMs));
+    stop();
+    clock = wallClock;
+    return replayed;
+}
+
+void RealTimeData::requestData(int maxRetries, int retryDelayMs) {
+    for (const auto& state : symbolStates) {
+        const Contract& contract = state->contract;
+        STX_LOGD(logger, "Created contract: Symbol=" + contract.symbol + ", SecType=" + contract.secType + ", Exchange=" + contract.exchange + ", Currency=" + contract.currency);
+
+        for (int attempt = 0; attempt < maxRetries; ++attempt) {
+            try {
+                int l1RequestId = tickerIdFor(state->index, L1_STREAM);
+                int l2RequestId = tickerIdFor(state->index, L2_STREAM);
+                state->bookResetPending.store(true);
+
+                // Tick-by-tick trades replace the conflated L1 LAST/LAST_SIZE stream.
+                // The requests only queue a few bytes on the socket, so they are sent inline.
+                if (config.tickByTick) {
+                    requestTickByTickData(state->index, contract);
+                } else {
+                    requestL1Data(l1RequestId, contract);
+                }
+                requestL2Data(l2RequestId, contract);
+                break;
+            } catch (const std::exception &e) {
+                STX_LOGE(logger, "Error during requestData for " + contract.symbol + ": " + std::string(e.what()));
+                if (attempt < maxRetries - 1) {
+                    STX_LOGW(logger, "Retrying data request in " + std::to_string(retryDelayMs) + "ms...");
+                    std::this_thread::sleep_for(std::chrono::milliseconds(retryDelayMs));
+                }
             }
         }
+
+        // Two or three requests per symbol; stay under the TWS limit of 50 messages per second.
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.tickByTick ? REQUEST_PACING_MS * 3 / 2 : REQUEST_PACING_MS));
     }
 }
 
@@ -249,465 +390,312 @@ void RealTimeData::requestL1Data(int l1RequestId, const Contract& contract) {
 void RealTimeData::requestL2Data(int l2RequestId, const Contract& contract) {
     STX_LOGD(logger, "Requesting L2 data with request ID: " + std::to_string(l2RequestId));
     TagValueListSPtr mktDepthOptionsPtr = std::make_shared<std::vector<std::shared_ptr<TagValue>>>();
-    client->reqMktDepth(l2RequestId, contract, 60, false, mktDepthOptionsPtr);
+    // Depth on a SMART-routed contract must be requested as SMART depth.
+    client->reqMktDepth(l2RequestId, contract, MARKET_DEPTH_ROWS, contract.exchange == "SMART", mktDepthOptionsPtr);
+}
+
+void RealTimeData::requestTickByTickData(size_t symbolIndex, const Contract& contract) {
+    STX_LOGD(logger, "Requesting tick-by-tick data for " + contract.symbol);
+    client->reqTickByTickData(tickerIdFor(symbolIndex, TICK_TRADE_STREAM), contract, "AllLast", 0, false);
+    client->reqTickByTickData(tickerIdFor(symbolIndex, TICK_QUOTE_STREAM), contract, "BidAsk", 0, false);
+}
+
+TickerId RealTimeData::tickerIdFor(size_t symbolIndex, StreamType stream) {
+    return static_cast<TickerId>(symbolIndex * STREAMS_PER_SYMBOL + stream + 1);
+}
+
+RealTimeData::SymbolState* RealTimeData::routeTicker(TickerId tickerId) const {
+    if (tickerId < 1) return nullptr;
+    size_t index = static_cast<size_t>(tickerId - 1) / STREAMS_PER_SYMBOL;
+    return index < symbolStates.size() ? symbolStates[index].get() : nullptr;
 }
 
 void RealTimeData::tickPrice(TickerId tickerId, TickType field, double price, const TickAttrib &attrib) {
-    if (field == LAST) {
-        l1Prices.push_back(price);
+    if (field == LAST || field == BID || field == ASK) {
+        SymbolState* state = routeTicker(tickerId);
+        if (!state) return;
+        state->l1Ring.push({price, 0, field});
         STX_LOGD(logger, "Received tick price: {\"TickerId\": " + std::to_string(tickerId) + ", \"Price\": " + std::to_string(price) + "}");
     }
 }
 
 void RealTimeData::tickSize(TickerId tickerId, TickType field, Decimal size) {
-    if (field == LAST_SIZE) {
-        l1Volumes.push_back(size);
+    if (field == LAST_SIZE || field == BID_SIZE || field == ASK_SIZE) {
+        SymbolState* state = routeTicker(tickerId);
+        if (!state) return;
+        state->l1Ring.push({0.0, decimalToQuantity(size), field});
         STX_LOGD(logger, "Received tick size: {\"TickerId\": " + std::to_string(tickerId) + ", \"Size\": " + DecimalFunctions::decimalToString(size) + "}");
     }
 }
 
 void RealTimeData::updateMktDepth(TickerId id, int position, int operation, int side, double price, Decimal size) {
-    std::string sideStr = side == 0 ? "Buy" : "Sell";
-
-    switch (operation) {
-        case 0:
-            rawL2Data[position].emplace_back(price, size, sideStr, "Inserted");
-            break;
-        case 1:
-            if (!rawL2Data[position].empty()) {
-                auto& latest = rawL2Data[position].back();
-                if (latest.status != "Deleted") {
-                    latest.price = price;
-                    latest.volume = size;
-                    latest.status = "Updated";
-                } else {
-                    rawL2Data[position].emplace_back(price, size, sideStr, "Inserted");
-                }
-            } else {
-                rawL2Data[position].emplace_back(price, size, sideStr, "Inserted");
-            }
-            break;
-        case 2: 
-            if (!rawL2Data[position].empty()) {
-                auto& latest = rawL2Data[position].back();
-                latest.status = "Deleted";
-            }
-            break;
-        default:
-            STX_LOGW(logger, "Unknown operation in updateMktDepth: " + std::to_string(operation));
-            break;
-    }
+    SymbolState* state = routeTicker(id);
+    if (!state) return;
+    state->l2Ring.push({price, decimalToQuantity(size), position, operation, side});
 }
 
-void RealTimeData::aggregateMinuteData() {
-    if (l1Prices.empty() || l1Volumes.empty() || rawL2Data.empty()) {
-        STX_LOGW(logger, "Incomplete data. Clearing temporary data and skipping aggregation.");
-        clearTemporaryData();
-        return;
-    }
-
-    swapBuffers();
-    moveDeletedItemsToBuffer();
-    updateHistoricalData();
-    
-    STX_LOGI(logger, "Aggregating minute data. L1 Prices count: " + std::to_string(l1PricesBuffer.size()) + 
-             ", L1 Volumes count: " + std::to_string(l1VolumesBuffer.size()) + 
-             ", Raw L2 Data count: " + std::to_string(countL2data(rawL2DataBuffer)));
-
-    try {
-        json l1Data, l2Data, features;
-        
-        auto l1Future = std::async(std::launch::async, [this]() {
-            return this->aggregateL1Data();
-        });
-
-        auto l2Future = std::async(std::launch::async, [this]() {
-            return this->aggregateL2Data();
-        });
-
-        l1Data = l1Future.get();
-        l2Data = l2Future.get();
-        features = calculateFeatures(l1Data, l2Data);
-
-        std::string datetime = getCurrentDateTime();
-#ifndef __TEST__
-        addToQueue(datetime, l1Data, l2Data, features);
-#endif
-        writeToSharedMemory(createCombinedJson(datetime, l1Data, l2Data, features));
-
-        clearBufferData();
-    } catch (const std::exception &e) {
-        clearBufferData();
-        STX_LOGE(logger, "Error in aggregateMinuteData: " + std::string(e.what()));
-    }
+void RealTimeData::tickByTickAllLast(int reqId, int tickType, time_t time, double price, Decimal size, const TickAttribLast& tickAttribLast, const std::string& exchange, const std::string& specialConditions) {
+    SymbolState* state = routeTicker(reqId);
+    if (!state) return;
+    uint32_t attributes = (tickAttribLast.pastLimit ? TICK_PAST_LIMIT : 0) | (tickAttribLast.unreported ? TICK_UNREPORTED : 0);
+    pushTickEvent(*state, TickEvent::make(time, price, decimalToQuantity(size), TickKind::Trade, attributes, state->tickSequence++));
 }
 
-json RealTimeData::aggregateL1Data() {
-    double open = l1PricesBuffer.front();
-    double close = l1PricesBuffer.back();
-    double high = *std::max_element(l1PricesBuffer.begin(), l1PricesBuffer.end());
-    double low = *std::min_element(l1PricesBuffer.begin(), l1PricesBuffer.end());
-    Decimal volume = std::accumulate(l1VolumesBuffer.begin(), l1VolumesBuffer.end(), Decimal(0), DecimalFunctions::add);
-    
-    std::string aggregateResult = "open: " + std::to_string(open) +
-                                "  close: " + std::to_string(close) +
-                                "  high: " + std::to_string(high) +
-                                "  low: " + std::to_string(low) +
-                                "  volume: " + DecimalFunctions::decimalToString(volume);
-
-    STX_LOGD(logger, aggregateResult);
-
-    return {
-        {"Open", open},
-        {"High", high},
-        {"Low", low},
-        {"Close", close},
-        {"Volume", DecimalFunctions::decimalToString(volume)}
-    };
+void RealTimeData::tickByTickBidAsk(int reqId, time_t time, double bidPrice, double askPrice, Decimal bidSize, Decimal askSize, const TickAttribBidAsk& tickAttribBidAsk) {
+    SymbolState* state = routeTicker(reqId);
+    if (!state) return;
+    uint32_t attributes = (tickAttribBidAsk.bidPastLow ? TICK_BID_PAST_LOW : 0) | (tickAttribBidAsk.askPastHigh ? TICK_ASK_PAST_HIGH : 0);
+    uint32_t sequence = state->tickSequence++;
+    pushTickEvent(*state, TickEvent::make(time, bidPrice, decimalToQuantity(bidSize), TickKind::Bid, attributes, sequence));
+    pushTickEvent(*state, TickEvent::make(time, askPrice, decimalToQuantity(askSize), TickKind::Ask, attributes, sequence));
 }
 
-json RealTimeData::aggregateL2Data() {
-    double minPrice = std::numeric_limits<double>::max();
-    double maxPrice = std::numeric_limits<double>::lowest();
-    std::map<int, L2DataPoint> currentState;
-
-    for (const auto& [position, dataPoints] : rawL2DataBuffer) {
-        if (dataPoints.empty()) continue;
-
-        for (const auto& data : dataPoints) {
-            if (data.price == 0.0) continue;
-
-            minPrice = std::min(minPrice, data.price);
-            maxPrice = std::max(maxPrice, data.price);
-        }
-    }
-
-    double interval = (maxPrice - minPrice) / 20;
-    if (interval == 0.0) {
-        STX_LOGE(logger, "Interval calculation failed due to identical min and max prices.");
-        return json::array();
-    }
-
-    std::string aggregateResult = "minPrice: " + std::to_string(minPrice) + 
-                                "  maxPrice: " + std::to_string(maxPrice) + 
-                                "  interval: " + std::to_string(interval);
-
-    STX_LOGD(logger, aggregateResult);
-
-    json l2DataJson = json::array();
-    std::vector<std::pair<Decimal, Decimal>> priceLevelBuckets(20, {0, 0});
-
-    for (const auto& [position, dataPoints] : rawL2DataBuffer) {
-        if (dataPoints.empty()) continue;
-
-        for (const auto& data : dataPoints) {
-            if (data.price == 0.0) continue;
-
-            int bucketIndex = static_cast<int>((data.price - minPrice) / interval);
-            bucketIndex = std::clamp(bucketIndex, 0, 19);
-
-            if (data.side == "Buy") {
-                priceLevelBuckets[bucketIndex].first = DecimalFunctions::add(priceLevelBuckets[bucketIndex].first, data.volume);
-            } else {
-                priceLevelBuckets[bucketIndex].second = DecimalFunctions::add(priceLevelBuckets[bucketIndex].second, data.volume);
-            }
-        }
-    }
-
-    for (int i = 0; i < 20; ++i) {
-        double midPrice = minPrice + (i + 0.5) * interval;
-        json level = {
-            {"Price", midPrice},
-            {"BuyVolume", DecimalFunctions::decimalToString(priceLevelBuckets[i].first)},
-            {"SellVolume", DecimalFunctions::decimalToString(priceLevelBuckets[i].second)}
-        };
-        l2DataJson.push_back(level);
-    }
-
-    return l2DataJson;
-}
-
-void RealTimeData::updateHistoricalData() {
-    if (!l1PricesBuffer.empty()) {
-        double closePrice = l1PricesBuffer.back();
-        Decimal totalVolume = std::accumulate(l1VolumesBuffer.begin(), l1VolumesBuffer.end(), Decimal(0), DecimalFunctions::add);
-        
-        historicalClosePrices.push_back(closePrice);
-        historicalVolumes.push_back(DecimalFunctions::decimalToDouble(totalVolume));
-        
-        if (historicalClosePrices.size() > MAX_HISTORY_SIZE) {
-            historicalClosePrices.pop_front();
-            historicalVolumes.pop_front();
-        }
-    }
+void RealTimeData::tickByTickMidPoint(int reqId, time_t time, double midPoint) {
+    SymbolState* state = routeTicker(reqId);
+    if (!state) return;
+    pushTickEvent(*state, TickEvent::make(time, midPoint, 0, TickKind::MidPoint, 0, state->tickSequence++));
 }
 
-json RealTimeData::calculateFeatures(const json& l1Data, const json& l2Data) {
-    std::future<double> weightedAvgPriceFuture = std::async(std::launch::async, &RealTimeData::calculateWeightedAveragePrice, this);
-    std::future<double> buySellRatioFuture = std::async(std::launch::async, &RealTimeData::calculateBuySellRatio, this);
-    std::future<Decimal> depthChangeFuture = std::async(std::launch::async, &RealTimeData::calculateDepthChange, this);
-    Decimal volume = DecimalFunctions::stringToDecimal(l1Data["Volume"].get<std::string>());
-    std::future<double> impliedLiquidityFuture = std::async(std::launch::async, &RealTimeData::calculateImpliedLiquidity, this);
-    std::future<double> priceMomentumFuture = std::async(std::launch::async, &RealTimeData::calculatePriceMomentum, this);
-    std::future<double> tradeDensityFuture = std::async(std::launch::async, &RealTimeData::calculateTradeDensity, this);
-    std::future<double> rsiFuture = std::async(std::launch::async, &RealTimeData::calculateRSI, this);
-    std::future<double> macdFuture = std::async(std::launch::async, &RealTimeData::calculateMACD, this);
-    std::future<double> vwapFuture = std::async(std::launch::async, &RealTimeData::calculateVWAP, this);
-
-    double weightedAvgPrice = weightedAvgPriceFuture.get();
-    double buySellRatio = buySellRatioFuture.get();
-    Decimal depthChange = depthChangeFuture.get();
-    double impliedLiquidity = impliedLiquidityFuture.get();
-    double priceMomentum = priceMomentumFuture.get();
-    double tradeDensity = tradeDensityFuture.get();
-    double rsi = rsiFuture.get();
-    double macd = macdFuture.get();
-    double vwap = vwapFuture.get();
-
-    return {
-        {"WeightedAvgPrice", weightedAvgPrice},
-        {"BuySellRatio", buySellRatio},
-        {"DepthChange", DecimalFunctions::decimalToString(depthChange)},
-        {"ImpliedLiquidity", impliedLiquidity},
-        {"PriceMomentum", priceMomentum},
-        {"TradeDensity", tradeDensity},
-        {"RSI", rsi},
-        {"MACD", macd},
-        {"VWAP", vwap}
-    };
+void RealTimeData::pushTickEvent(SymbolState& state, const TickEvent& event) {
+    state.tickRing.push(event);
 }
 
-std::string RealTimeData::getCurrentDateTime() const {
-    std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-    std::time_t in_time_t = std::chrono::system_clock::to_time_t(now);
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
+// Depth updates drained together share the drain time `nowNs`, so the time
+// weighting resolves the book to RING_DRAIN_INTERVAL_MS.
+void RealTimeData::drainRings(SymbolState& state, int64_t nowNs) {
+    // TWS replays the whole book after a fresh reqMktDepth, so start from an empty one.
+    if (state.bookResetPending.exchange(false)) {
+        state.depth.reset(nowNs);
+        state.book.clear();
+    }
 
-void RealTimeData::addToQueue(const std::string& datetime, const json& l1Data, const json& l2Data, const json& features) {
-    std::unique_lock<std::mutex> queueLock(queueMutex, std::defer_lock);
-    queueLock.lock();
-    dataQueue.emplace(datetime, l1Data, l2Data, features);
-    queueLock.unlock();
-    queueCV.notify_one();
+    size_t l1Pending = state.l1Ring.size();
+    size_t l2Pending = state.l2Ring.size();
+    size_t tickPending = state.tickRing.size();
+    if (l1Pending > state.l1HighWater.load(std::memory_order_relaxed)) state.l1HighWater.store(l1Pending, std::memory_order_relaxed);
+    if (l2Pending > state.l2HighWater.load(std::memory_order_relaxed)) state.l2HighWater.store(l2Pending, std::memory_order_relaxed);
+    if (tickPending > state.tickHighWater.load(std::memory_order_relaxed)) state.tickHighWater.store(tickPending, std::memory_order_relaxed);
+
+    state.l1Ring.drain([this, &state](const L1Event& event) {
+        applyL1Event(state, event);
+    });
+    state.l2Ring.drain([this, &state, nowNs](const L2Event& event) {
+        applyL2Event(state, event, nowNs);
+    });
+    state.tickRing.drain([this, &state](const TickEvent& event) {
+        applyTickEvent(state, event);
+    });
 }
 
-void RealTimeData::writeToSharedMemory(const std::string &data) {
-    try {
-        if (data.size() > region.get_size()) {
-            throw std::runtime_error("Data size exceeds shared memory size");
-        }
-        std::memset(region.get_address(), 0, region.get_size());
-        std::memcpy(region.get_address(), data.c_str(), data.size());
-        STX_LOGI(logger, "Data written to shared memory");
-    } catch (const std::exception &e) {
-        STX_LOGE(logger, "Error writing to shared memory: " + std::string(e.what()));
+void RealTimeData::applyL1Event(SymbolState& state, const L1Event& event) {
+    switch (event.field) {
+        case LAST:
+            state.bars.onPrice(event.price);
+            state.lastTradePrice = event.price;
+            break;
+        case LAST_SIZE:
+            state.bars.onSize(event.size);
+            signTrade(state, state.lastTradePrice, event.size);
+            break;
+        case BID:
+            state.quote.bid = event.price;
+            state.micro.sampleQuote(state.quote);
+            break;
+        case ASK:
+            state.quote.ask = event.price;
+            state.micro.sampleQuote(state.quote);
+            break;
+        // TWS sends UNSET_DECIMAL sizes; the last known size stands instead.
+        case BID_SIZE:
+            if (event.size == UNSET_QUANTITY) break;
+            state.quote.bidSize = event.size;
+            state.micro.sampleQuote(state.quote);
+            break;
+        case ASK_SIZE:
+            if (event.size == UNSET_QUANTITY) break;
+            state.quote.askSize = event.size;
+            state.micro.sampleQuote(state.quote);
+            break;
+        default:
+            break;
     }
 }
 
-std::string RealTimeData::createCombinedJson(const std::string& datetime, const json& l1Data, const json& l2Data, const json& features) const {
-    json combinedData = {
-        {"datetime", datetime},
-        {"L1", l1Data},
-        {"L2", l2Data},
-        {"Features", features}
-    };
-    return combinedData.dump();
+void RealTimeData::applyTickEvent(SymbolState& state, const TickEvent& event) {
+    switch (event.kind()) {
+        case TickKind::Trade:
+            state.bars.onPrice(event.price);
+            state.bars.onSize(event.size);
+            signTrade(state, event.price, event.size);
+            break;
+        case TickKind::Bid:
+            state.quote.bid = event.price;
+            if (event.size != UNSET_QUANTITY) state.quote.bidSize = event.size;
+            break;
+        case TickKind::Ask:
+            // The ask always follows the bid of the same BidAsk quote; sample the pair once.
+            state.quote.ask = event.price;
+            if (event.size != UNSET_QUANTITY) state.quote.askSize = event.size;
+            state.micro.sampleQuote(state.quote);
+            break;
+        default:
+            break;
+    }
+    state.ticks.push_back(event);
 }
 
-void RealTimeData::swapBuffers() {
-    std::unique_lock<std::mutex> dataLock(dataMutex, std::defer_lock);
-    dataLock.lock();
-    std::swap(l1Prices, l1PricesBuffer);
-    std::swap(l1Volumes, l1VolumesBuffer);
-    dataLock.unlock();
+// Signs against the quote prevailing when the trade is drained, not a lagged one.
+void RealTimeData::signTrade(SymbolState& state, double price, Quantity size) {
+    if (price <= 0.0 || size == UNSET_QUANTITY) return;
+    state.micro.addTrade(state.signer.classify(price, state.quote), size);
 }
 
-void RealTimeData::moveDeletedItemsToBuffer() {
-    std::lock_guard<std::mutex> lock(dataMutex);
-    for (auto& [position, dataPoints] : rawL2Data) {
-        auto it = std::stable_partition(dataPoints.begin(), dataPoints.end(),
-            [](const L2DataPoint& point) { return point.status != "Deleted"; });
-        
-        rawL2DataBuffer[position].insert(rawL2DataBuffer[position].end(),
-            std::make_move_iterator(it), std::make_move_iterator(dataPoints.end()));
-        
-        dataPoints.erase(it, dataPoints.end());
+// Folds the second's tick-by-tick events, microstructure samples and resting
+// depth into every resolution's open bar and empties the per-second state.
+void RealTimeData::closeSecond(SymbolState& state, int64_t nowNs) {
+    state.depth.flush(nowNs);
+    accumulateTickFeatures(state.tickFeatures, state.ticks.data(), state.ticks.size());
+    state.ticks.clear();
+
+    for (BarSeries& series : state.series) {
+        series.ticks.merge(state.tickFeatures);
+        series.micro.merge(state.micro);
+        series.depth.merge(state.depth.histogram());
     }
+    state.depth.clearHistogram();
+    state.tickFeatures.reset();
+    state.micro.reset();
 }
 
-void RealTimeData::clearBufferData() {
-    STX_LOGI(logger, "Clearing buffer data. L1 Prices count: " + std::to_string(l1PricesBuffer.size()) + ", L1 Volumes count: " + std::to_string(l1VolumesBuffer.size()) + ", Raw L2 Data count: " + std::to_string(countL2data(rawL2DataBuffer)));
-    l1PricesBuffer.clear();
-    l1VolumesBuffer.clear();
-    rawL2DataBuffer.clear();
-}
-
-void RealTimeData::clearTemporaryData() {
-    std::unique_lock<std::mutex> dataLock(dataMutex, std::defer_lock);
-    dataLock.lock();
-    STX_LOGI(logger, "Clearing temporary data. L1 Prices count: " + std::to_string(l1Prices.size()) + ", L1 Volumes count: " + std::to_string(l1Volumes.size()) + ", Raw L2 Data count: " + std::to_string(countL2data(rawL2Data)));
-    l1Prices.clear();
-    l1Volumes.clear();
-    rawL2Data.clear();
-    dataLock.unlock();
+void RealTimeData::applyL2Event(SymbolState& state, const L2Event& event, int64_t nowNs) {
+    if (!state.depth.apply(state.book, event.position, event.operation, event.side, event.price, event.size, nowNs)) {
+        STX_LOGW(logger, "Invalid updateMktDepth for " + state.contract.symbol + ": position=" + std::to_string(event.position) +
+                 ", operation=" + std::to_string(event.operation) + ", side=" + std::to_string(event.side));
+        return;
+    }
+    state.bookChanged = true;
 }
 
-int RealTimeData::countL2data(const std::map<int, std::vector<L2DataPoint>>& l2data) const {
-    return std::accumulate(l2data.begin(), l2data.end(), 0,
-        [](int sum, const auto& pair) {
-            return sum + pair.second.size();
+std::vector<RealTimeData::RingStats> RealTimeData::getRingStats() const {
+    std::vector<RingStats> stats;
+    stats.reserve(symbolStates.size());
+    for (const auto& state : symbolStates) {
+        stats.push_back({
+            state->contract.symbol,
+            state->l1Ring.size(), state->l1HighWater.load(std::memory_order_relaxed), state->l1Ring.dropped(),
+            state->l2Ring.size(), state->l2HighWater.load(std::memory_order_relaxed), state->l2Ring.dropped(),
+            state->tickRing.size(), state->tickHighWater.load(std::memory_order_relaxed), state->tickRing.dropped()
         });
-}
-
-double RealTimeData::calculateWeightedAveragePrice() const {
-    if (l1PricesBuffer.empty() || l1VolumesBuffer.empty()) return 0.0;
-
-    Decimal totalWeightedPrice = 0;
-    Decimal totalVolume = 0;
-    for (size_t i = 0; i < l1PricesBuffer.size(); ++i) {
-        totalWeightedPrice = DecimalFunctions::add(totalWeightedPrice, DecimalFunctions::mul(DecimalFunctions::doubleToDecimal(l1PricesBuffer[i]), l1VolumesBuffer[i]));
-        totalVolume = DecimalFunctions::add(totalVolume, l1VolumesBuffer[i]);
     }
-    return totalVolume == 0 ? 0.0 : DecimalFunctions::decimalToDouble(DecimalFunctions::div(totalWeightedPrice, totalVolume));
+    return stats;
 }
 
-double RealTimeData::calculateBuySellRatio() const {
-    Decimal totalBuyVolume = 0;
-    Decimal totalSellVolume = 0;
-    for (const auto& [position, dataPoints] : rawL2DataBuffer) {
-        if (dataPoints.empty()) continue;
-
-        for (const auto& data : dataPoints) {
-            if (data.price == 0.0) continue;
+RealTimeBar RealTimeData::buildRow(const BarSeries& series, const BookFeatures* bookFeatures) {
+    const OhlcvBar& bar = series.lastBar;
+    STX_LOGD(logger, "open: " + std::to_string(bar.open) + "  close: " + std::to_string(bar.close) +
+             "  high: " + std::to_string(bar.high) + "  low: " + std::to_string(bar.low) +
+             "  volume: " + std::to_string(quantityToDouble(bar.volume)));
 
-            if (data.side == "Buy") {
-                totalBuyVolume = DecimalFunctions::add(totalBuyVolume, data.volume);
-            } else {
-                totalSellVolume = DecimalFunctions::add(totalSellVolume, data.volume);
-            }
-        }
+    RealTimeBar row = barRow(series, bookFeatures);
+    row.depth = depthRows(series.depth);
+    if (row.depth.empty() && bookFeatures) {
+        STX_LOGW(logger, "No resting depth recorded for the " + resolutionLabel(series.seconds) + " bar.");
     }
-    return totalSellVolume == 0 ? 0.0 : DecimalFunctions::decimalToDouble(DecimalFunctions::div(totalBuyVolume, totalSellVolume));
+    return row;
 }
 
-Decimal RealTimeData::calculateDepthChange() const {
-    Decimal totalBuyVolume = 0;
-    Decimal totalSellVolume = 0;
-    for (const auto& [position, dataPoints] : rawL2DataBuffer) {
-        if (dataPoints.empty()) continue;
-
-        for (const auto& data : dataPoints) {
-            if (data.price == 0.0) continue;
-
-            if (data.side == "Buy") {
-                totalBuyVolume = DecimalFunctions::add(totalBuyVolume, data.volume);
-            } else if (data.side == "Sell") {
-                totalSellVolume = DecimalFunctions::add(totalSellVolume, data.volume);
-            }
-        }
-    }
-    return DecimalFunctions::sub(totalBuyVolume, totalSellVolume);
+std::string RealTimeData::getCurrentDateTime() const {
+    return formatDateTime(std::chrono::system_clock::to_time_t(clock->now()));
 }
 
-double RealTimeData::calculateImpliedLiquidity() const {
-    double totalBuyVolume = 0.0;
-    double totalSellVolume = 0.0;
-    double highestBid = std::numeric_limits<double>::lowest();
-    double lowestAsk = std::numeric_limits<double>::max();
-
-    for (const auto& [position, dataPoints] : rawL2DataBuffer) {
-        if (dataPoints.empty()) continue;
-
-        for (const auto& data : dataPoints) {
-            if (data.price == 0.0) continue;
-
-            if (data.side == "Buy") {
-                totalBuyVolume += DecimalFunctions::decimalToDouble(data.volume);
-                highestBid = std::max(highestBid, data.price);
-            } else if (data.side == "Sell") {
-                totalSellVolume += DecimalFunctions::decimalToDouble(data.volume);
-                lowestAsk = std::min(lowestAsk, data.price);
-            }
-        }
-    }
-
-    double averageBuyVolume = totalBuyVolume / rawL2DataBuffer.size();
-    double averageSellVolume = totalSellVolume / rawL2DataBuffer.size();
-    double spread = lowestAsk - highestBid;
-
-    if (spread <= 0) {
-        return 0.0;
-    }
-
-    return (averageBuyVolume + averageSellVolume) / spread;
+std::string RealTimeData::formatDateTime(std::time_t time) const {
+    std::tm localTime;
+    localtime_r(&time, &localTime);
+    std::ostringstream oss;
+    oss << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
 }
 
-double RealTimeData::calculatePriceMomentum() const {
-    if (historicalClosePrices.size() < 2) return 0.0;
-    return historicalClosePrices.back() - historicalClosePrices.front();
+void RealTimeData::addToQueue(RealTimeBar&& row) {
+    std::unique_lock<std::mutex> queueLock(queueMutex, std::defer_lock);
+    queueLock.lock();
+    dataQueue.push(std::move(row));
+    queueLock.unlock();
+    queueCV.notify_one();
 }
 
-double RealTimeData::calculateTradeDensity() const {
-    if (historicalVolumes.empty()) return 0.0;
-    double totalVolume = std::accumulate(historicalVolumes.begin(), historicalVolumes.end(), 0.0);
-    return totalVolume / historicalVolumes.size();
+// Channels are laid out symbol-major: all resolutions of symbol 0, then symbol 1, ...
+size_t RealTimeData::sharedMemoryChannel(const SymbolState& state, size_t resolutionIndex) const {
+    return state.index * config.barResolutions.size() + resolutionIndex;
 }
 
-double RealTimeData::calculateRSI() const {
-    if (historicalClosePrices.size() < 15) return 50.0;
-
-    double gains = 0.0, losses = 0.0;
-    for (size_t i = historicalClosePrices.size() - 14; i < historicalClosePrices.size(); ++i) {
-        double change = historicalClosePrices[i] - historicalClosePrices[i - 1];
-        if (change > 0) {
-            gains += change;
-        } else {
-            losses -= change;
-        }
-    }
-
-    double avgGain = gains / 14;
-    double avgLoss = losses / 14;
-    double rs = (avgLoss == 0) ? avgGain : avgGain / avgLoss;
-    return 100.0 - (100.0 / (1.0 + rs));
+// Snapshot channels follow all bar channels, one per symbol.
+size_t RealTimeData::snapshotChannel(const SymbolState& state) const {
+    return symbolStates.size() * config.barResolutions.size() + state.index;
 }
 
-double RealTimeData::calculateMACD() const {
-    if (historicalClosePrices.size() < 26) return 0.0;
+namespace {
 
-    double shortEMA = calculateEMA(12);
-    double longEMA = calculateEMA(26);
+void fillBarFields(SharedMemoryBarRecord& record, const OhlcvBar& bar) {
+    record.open = bar.open;
+    record.high = bar.high;
+    record.low = bar.low;
+    record.close = bar.close;
+    record.volume = bar.volume;
+    record.tradeCount = bar.tradeCount;
+    record.vwap = bar.vwap();
+}
 
-    return shortEMA - longEMA;
+void fillBookFields(SharedMemoryBarRecord& record, const OrderBook& book, const BookFeatures& bookFeatures) {
+    record.bestBid = book.bestBid();
+    record.bestAsk = book.bestAsk();
+    record.bidVolume = bookFeatures.bidVolume;
+    record.askVolume = bookFeatures.askVolume;
+    record.buySellRatio = bookFeatures.buySellRatio;
+    record.impliedLiquidity = bookFeatures.impliedLiquidity;
 }
 
-double RealTimeData::calculateEMA(int period) const {
-    if (historicalClosePrices.size() < period) return historicalClosePrices.back();
+void fillIndicatorFields(SharedMemoryBarRecord& record, const BarSeries& series) {
+    record.priceMomentum = series.momentum.value();
+    record.tradeDensity = series.tradeDensity.value();
+    record.rsi = series.rsi.value();
+    record.macd = series.macd.value();
+    record.macdSignal = series.macd.signal();
+    record.rollingVwap = series.vwap.value();
+}
 
-    double multiplier = 2.0 / (period + 1);
-    double ema = std::accumulate(historicalClosePrices.end() - period, historicalClosePrices.end(), 0.0) / period;
+} // namespace
 
-    for (auto it = historicalClosePrices.end() - period; it != historicalClosePrices.end(); ++it) {
-        ema = (*it - ema) * multiplier + ema;
-    }
+SharedMemoryBarRecord RealTimeData::barRecord(const SymbolState& state, size_t resolutionIndex, int64_t boundary, const BookFeatures& bookFeatures) const {
+    const BarSeries& series = state.series[resolutionIndex];
 
-    return ema;
+    SharedMemoryBarRecord record{};
+    record.timestamp = boundary;
+    fillBarFields(record, series.lastBar);
+    fillBookFields(record, state.book, bookFeatures);
+    fillIndicatorFields(record, series);
+    return record;
 }
 
-double RealTimeData::calculateVWAP() const {
-    if (historicalClosePrices.empty() || historicalVolumes.empty()) return 0.0;
+// Publishes the book features of a changed book, at most once per book_snapshot_ms.
+// A change inside the throttle window stays pending and goes out with a later drain.
+void RealTimeData::publishBookSnapshot(SymbolState& state, Clock::TimePoint now) {
+    if (!sharedMemoryWriter || !state.bookChanged || state.book.empty()) return;
+    if (now - state.lastSnapshot < std::chrono::milliseconds(config.bookSnapshotMs)) return;
+    state.bookChanged = false;
+    state.lastSnapshot = now;
 
-    double cumulativePriceVolume = 0.0;
-    double cumulativeVolume = 0.0;
+    SharedMemoryBarRecord record{};
+    record.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    fillBarFields(record, state.bars.openBar());
+    fillBookFields(record, state.book, computeBookFeatures(state.book));
+    fillIndicatorFields(record, state.series.front());
 
-    for (size_t i = 0; i < historicalClosePrices.size(); ++i) {
-        cumulativePriceVolume += historicalClosePrices[i] * historicalVolumes[i];
-        cumulativeVolume += historicalVolumes[i];
+    try {
+        sharedMemoryWriter->publish(snapshotChannel(state), record);
+    } catch (const std::exception &e) {
+        STX_LOGE(logger, "Error writing book snapshot to shared memory: " + std::string(e.what()));
     }
-
-    return cumulativeVolume == 0 ? 0.0 : cumulativePriceVolume / cumulativeVolume;
 }
 
 void RealTimeData::nextValidId(OrderId orderId) {
@@ -721,7 +709,9 @@ void RealTimeData::nextValidId(OrderId orderId) {
 }
 
 void RealTimeData::error(int id, int errorCode, const std::string &errorString, const std::string &advancedOrderRejectJson) {
-    STX_LOGW(logger, "IB API Error: ID=" + std::to_string(id) + ", Code=" + std::to_string(errorCode) + ", Message=" + errorString);
+    SymbolState* state = routeTicker(id);
+    std::string symbol = state ? ", Symbol=" + state->contract.symbol : "";
+    STX_LOGW(logger, "IB API Error: ID=" + std::to_string(id) + symbol + ", Code=" + std::to_string(errorCode) + ", Message=" + errorString);
     
     if (!advancedOrderRejectJson.empty()) {
         STX_LOGW(logger, "Advanced Order Reject JSON: " + advancedOrderRejectJson);
@@ -756,6 +746,12 @@ void RealTimeData::error(int id, int errorCode, const std::string &errorString,
         case 322:
             STX_LOGE(logger, "Duplicate ticker id. Ensure unique ticker ids for each request.");
             break;
+        case 309:
+            STX_LOGE(logger, "Max number of market depth requests reached. Reduce the L2 universe or add market depth lines.");
+            break;
+        case 10190:
+            STX_LOGE(logger, "Max number of tick-by-tick requests reached. Reduce the universe or disable realtime.tick_by_tick.");
+            break;
         case 504:
             STX_LOGE(logger, "Not connected. Attempting to reconnect...");
             reconnect();
@@ -820,33 +816,179 @@ void RealTimeData::reconnect() {
 void RealTimeData::initializeSharedMemory() {
     STX_LOGI(logger, "Initializing shared memory...");
     boost::interprocess::shared_memory_object::remove(SHARED_MEMORY_NAME);
+    std::vector<SharedMemoryChannelSpec> channels;
+    for (const auto& state : symbolStates) {
+        for (int seconds : config.barResolutions) {
+            channels.emplace_back(state->contract.symbol, seconds);
+        }
+    }
+    if (config.bookSnapshotMs >= 0) {
+        for (const auto& state : symbolStates) {
+            channels.emplace_back(state->contract.symbol, SHARED_MEMORY_SNAPSHOT_RESOLUTION);
+        }
+    }
+    const size_t size = SharedMemoryBarWriter::requiredSize(channels.size(), config.sharedMemoryHistory);
+
     shm = boost::interprocess::shared_memory_object(boost::interprocess::create_only, SHARED_MEMORY_NAME, boost::interprocess::read_write);
-    shm.truncate(SHARED_MEMORY_SIZE);
+    shm.truncate(size);
     region = boost::interprocess::mapped_region(shm, boost::interprocess::read_write);
+    sharedMemoryWriter = std::make_unique<SharedMemoryBarWriter>(region.get_address(), region.get_size(), channels, config.sharedMemoryHistory);
     STX_LOGI(logger, "Shared memory initialized successfully.");
 }
 
-void RealTimeData::processData() {
+void RealTimeData::initializeShards() {
+    size_t shardCount = std::max<size_t>(1, std::min(config.shards, symbolStates.size()));
+    shards = std::vector<Shard>(shardCount);
+    for (const auto& state : symbolStates) {
+        shards[state->index % shardCount].symbols.push_back(state.get());
+    }
+}
+
+void RealTimeData::buildTaskGraphs() {
+    for (Shard& shard : shards) {
+        Shard* unit = &shard;
+        drainGraph.add([this, unit] { drainShard(*unit); });
+
+        TaskGraph::NodeId drain = secondGraph.add([this, unit] { drainShard(*unit); });
+        TaskGraph::NodeId aggregate = secondGraph.add([this, unit] { aggregateShard(*unit); });
+        TaskGraph::NodeId features = secondGraph.add([this, unit] { buildShardPayloads(*unit); });
+        TaskGraph::NodeId publish = secondGraph.add([this, unit] { publishShard(*unit); });
+        secondGraph.precede(drain, aggregate);
+        secondGraph.precede(aggregate, features);
+        secondGraph.precede(features, publish);
+    }
+}
+
+// The only thread on the clock: it wakes every drain interval, runs one graph
+// on the pool and waits for it, so a cycle is finished before the next starts.
+void RealTimeData::runPipeline() {
+    Clock::TimePoint nextSecond = std::chrono::time_point_cast<std::chrono::seconds>(clock->now()) + std::chrono::seconds(1);
+
     while (running.load()) {
-        auto now = std::chrono::system_clock::now();
-        auto nextMinute = std::chrono::time_point_cast<std::chrono::minutes>(now) + std::chrono::minutes(1);
-        std::unique_lock<std::mutex> lock(cvMutex);
-        if (cv.wait_until(lock, nextMinute, [this] { return !running.load(); })) {
+        // Drain the rings frequently so they stay shallow; close bars only on second boundaries.
+        clock->waitUntil(nextSecond, std::chrono::milliseconds(RING_DRAIN_INTERVAL_MS));
+        if (!running.load()) {
             break; // Exit if stop() was called
         }
-        aggregateMinuteData();
+
+        cycleTime = clock->now();
+        cycleNs = std::chrono::duration_cast<std::chrono::nanoseconds>(cycleTime.time_since_epoch()).count();
+        cycleSecond = std::chrono::duration_cast<std::chrono::seconds>(cycleTime.time_since_epoch()).count();
+        const bool closesSecond = cycleTime >= nextSecond;
+        try {
+            (closesSecond ? secondGraph : drainGraph).run(*workers);
+        } catch (const std::exception &e) {
+            STX_LOGE(logger, "Error in the aggregation pipeline: " + std::string(e.what()));
+        }
+        if (closesSecond) {
+            nextSecond = std::chrono::time_point_cast<std::chrono::seconds>(cycleTime) + std::chrono::seconds(1);
+        }
+    }
+    clock->detach();
+}
+
+void RealTimeData::drainShard(Shard& shard) {
+    for (SymbolState* state : shard.symbols) {
+        drainRings(*state, cycleNs);
+    }
+    if (config.bookSnapshotMs >= 0) {
+        for (SymbolState* state : shard.symbols) {
+            publishBookSnapshot(*state, cycleTime);
+        }
+    }
+}
+
+// Closes the second for every symbol of the shard and collects the bars that ended with it.
+void RealTimeData::aggregateShard(Shard& shard) {
+    shard.closed.clear();
+    for (SymbolState* state : shard.symbols) {
+        closeSecond(*state, cycleNs);
+        state->bars.advance(cycleSecond, [this, &shard, state](size_t resolutionIndex, int64_t boundary, const OhlcvBar& bar) {
+            shard.closed.push_back({state, resolutionIndex, boundary, bar, false, RealTimeBar{}, SharedMemoryBarRecord{}});
+        });
+    }
+}
+
+// Folds each closed bar into its series and renders its row and shared memory
+// record. Bars are taken in closing order, so each payload sees the indicators
+// as of its own bar even when one series closed twice in a cycle.
+void RealTimeData::buildShardPayloads(Shard& shard) {
+    for (ClosedBar& closed : shard.closed) {
+        SymbolState& state = *closed.state;
+        BarSeries& series = state.series[closed.resolutionIndex];
+        const std::string label = resolutionLabel(series.seconds);
+        series.update(closed.bar);
+
+        STX_LOGD(logger, "Aggregating " + label + " bar for " + state.contract.symbol + ". Trades: " + std::to_string(closed.bar.tradeCount) +
+                 ", Book depth bid/ask: " + std::to_string(state.book.depth(BookSide::Bid)) + "/" + std::to_string(state.book.depth(BookSide::Ask)));
+
+        try {
+            // Without an L2 book (depth not subscribed or rejected) the bar still goes out; only its book fields stay empty.
+            const bool hasBook = !state.book.empty();
+            BookFeatures bookFeatures = hasBook ? computeBookFeatures(state.book) : BookFeatures{};
+            if (series.persist) closed.row = buildRow(series, hasBook ? &bookFeatures : nullptr);
+            closed.record = barRecord(state, closed.resolutionIndex, closed.boundary, bookFeatures);
+            closed.ready = true;
+        } catch (const std::exception &e) {
+            STX_LOGE(logger, "Error building " + label + " bar for " + state.contract.symbol + ": " + std::string(e.what()));
+        }
+    }
+
+    // The per-bar accumulators restart once every bar that read them is rendered.
+    for (SymbolState* state : shard.symbols) {
+        for (BarSeries& series : state->series) {
+            series.rollAccumulators(cycleSecond);
+        }
+    }
+}
+
+void RealTimeData::publishShard(Shard& shard) {
+    for (ClosedBar& closed : shard.closed) {
+        if (!closed.ready) continue;
+        const SymbolState& state = *closed.state;
+        const BarSeries& series = state.series[closed.resolutionIndex];
+
+#ifndef __TEST__
+        if (series.persist) {
+            closed.row.symbol = state.contract.symbol;
+            closed.row.resolution = series.seconds;
+            closed.row.datetime = utcTimestamp(closed.boundary);
+            addToQueue(std::move(closed.row));
+        }
+#endif
+        if (sharedMemoryWriter) {
+            const size_t channel = sharedMemoryChannel(state, closed.resolutionIndex);
+            try {
+                sharedMemoryWriter->publish(channel, closed.record);
+                STX_LOGD(logger, "Bar written to shared memory channel " + std::to_string(channel));
+            } catch (const std::exception &e) {
+                STX_LOGE(logger, "Error writing to shared memory: " + std::string(e.what()));
+            }
+        }
+        if (publishHook) {
+            publishHook(state.index, series.seconds, closed.boundary, closed.bar);
+        }
+    }
+    shard.closed.clear();
+
+    if (cycleSecond % 60 != 0) return;
+    for (SymbolState* state : shard.symbols) {
+        if (state->l1Ring.dropped() > 0 || state->l2Ring.dropped() > 0 || state->tickRing.dropped() > 0) {
+            STX_LOGW(logger, "Ring overflow for " + state->contract.symbol + ": dropped L1=" + std::to_string(state->l1Ring.dropped()) +
+                     ", L2=" + std::to_string(state->l2Ring.dropped()) + ", ticks=" + std::to_string(state->tickRing.dropped()) +
+                     ", high water L1=" + std::to_string(state->l1HighWater.load()) + ", L2=" + std::to_string(state->l2HighWater.load()) +
+                     ", ticks=" + std::to_string(state->tickHighWater.load()));
+        }
     }
 }
 
 void RealTimeData::monitorDataFlow(int maxRetries, int retryDelayMs, int checkIntervalMs) {
     while (running.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(checkIntervalMs));
-        std::unique_lock<std::mutex> lock(cvMutex);
-        if (cv.wait_for(lock, std::chrono::milliseconds(checkIntervalMs), [this] { return !running.load(); })) {
+        clock->waitUntil(clock->now() + std::chrono::milliseconds(checkIntervalMs), std::chrono::milliseconds(checkIntervalMs));
+        if (!running.load()) {
             break; // Exit if stop() was called
         }
-        lock.unlock();
-        
+
         if (!client || !client->isConnected()) {
             STX_LOGW(logger, "Connection lost. Attempting to reconnect...");
             if (!connectToIB(maxRetries, retryDelayMs)) {
@@ -856,30 +998,72 @@ void RealTimeData::monitorDataFlow(int maxRetries, int retryDelayMs, int checkIn
             requestData(maxRetries, retryDelayMs);
         }
     }
+    clock->detach();
 }
 
+// Group commit: everything queued, up to db_batch_rows, is written in one
+// transaction. With less than a full batch queued the writer waits up to
+// db_flush_ms for more rows; a backlog goes out in full batches back to back.
+// A failing database is retried for as long as the pipeline runs; after stop()
+// the queue gets DB_SHUTDOWN_ATTEMPTS more failures before it is dropped, so
+// shutdown cannot hang on a database that is down.
 void RealTimeData::writeToDatabaseFunc() {
-    while (running.load() || !dataQueue.empty()) {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        queueCV.wait(lock, [this] { return !dataQueue.empty() || !running.load(); });
+    const size_t maxRows = config.dbBatchRows;
+    std::vector<RealTimeBar> batch;
+    batch.reserve(maxRows);
+    int shutdownFailures = 0;
 
-        while (!dataQueue.empty()) {
-            auto [datetime, l1Data, l2Data, features] = dataQueue.front();
-            if (db->insertRealTimeData(datetime, l1Data, l2Data, features)) {
-                dataQueue.pop();
-                STX_LOGI(logger, "Data wtite into database successfulle: " + datetime);
-            } else {
-                STX_LOGE(logger, "Failed to write data to database, will retry.");
-                break; // Exit the loop to retry later
-            }
+    while (true) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueCV.wait(lock, [this, &batch] { return !dataQueue.empty() || !batch.empty() || !running.load(); });
+        if (!running.load() && dataQueue.empty() && batch.empty()) break;
+        queueCV.wait_for(lock, std::chrono::milliseconds(config.dbFlushMs), [this, &batch, maxRows] {
+            return batch.size() + dataQueue.size() >= maxRows || !running.load();
+        });
+        while (!dataQueue.empty() && batch.size() < maxRows) {
+            batch.push_back(std::move(dataQueue.front()));
+            dataQueue.pop();
         }
+        lock.unlock();
+        if (batch.empty()) continue;
+
+        const size_t rows = batch.size();
+        if (storeRows(batch)) {
+            STX_LOGD(logger, "Data wtite into database successfulle: " + std::to_string(rows) + " rows");
+            batch.clear();
+        } else if (!running.load() && ++shutdownFailures >= DB_SHUTDOWN_ATTEMPTS) {
+            size_t dropped = batch.size();
+            batch.clear();
+            lock.lock();
+            dropped += dataQueue.size();
+            std::queue<RealTimeBar>().swap(dataQueue);
+            lock.unlock();
+            STX_LOGE(logger, "Database still failing after stop, dropped " + std::to_string(dropped) + " unwritten rows.");
+            break;
+        } else {
+            // The unsent rows stay in the batch and go first next time.
+            STX_LOGE(logger, "Failed to write " + std::to_string(batch.size()) + " rows to database, will retry.");
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(config.dbFlushMs, 100)));
+        }
+    }
+}
+
+// A row sink stores row by row; rows it accepted are removed from `rows` even when a later one fails.
+bool RealTimeData::storeRows(std::vector<RealTimeBar>& rows) {
+    if (!rowSink) return db->insertRealTimeBars(rows);
+
+    size_t stored = 0;
+    for (; stored < rows.size(); ++stored) {
+        if (!rowSink(rows[stored])) break;
     }
+    rows.erase(rows.begin(), rows.begin() + stored);
+    return rows.empty();
 }
 
 void RealTimeData::joinThreads() {
-    if (processDataThread.joinable()) {
-        processDataThread.join();
-        STX_LOGI(logger, "processDataThread joined successfully");
+    if (pipelineThread.joinable()) {
+        pipelineThread.join();
+        STX_LOGI(logger, "pipelineThread joined successfully");
     }
     if (monitorDataFlowThread.joinable()) {
         monitorDataFlowThread.join();
@@ -900,7 +1084,8 @@ Contract RealTimeData::createContract(const std::string& symbol, const std::stri
     contract.symbol = symbol;
     contract.secType = secType;
     contract.exchange = exchange;
-    contract.primaryExchange = exchange;
+    // SMART is a router, not a listing venue; TWS rejects it as the primary exchange.
+    if (exchange != "SMART") contract.primaryExchange = exchange;
     contract.currency = currency;
     return contract;
 }
\ No newline at end of file
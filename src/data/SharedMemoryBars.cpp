@@ -0,0 +1,170 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "FixedPoint.hpp"
+#include "SharedMemoryBars.hpp"
+
+SharedMemoryBarWriter::SharedMemoryBarWriter(void* address, size_t size, const std::vector<SharedMemoryChannelSpec>& channelSpecs, uint32_t ringCapacity) {
+    if (channelSpecs.empty() || ringCapacity == 0) {
+        throw std::invalid_argument("Shared memory needs at least one channel and a non-empty ring");
+    }
+    if (size < requiredSize(channelSpecs.size(), ringCapacity)) {
+        throw std::invalid_argument("Shared memory region is too small for the bar rings");
+    }
+
+    char* base = static_cast<char*>(address);
+    std::memset(base, 0, requiredSize(channelSpecs.size(), ringCapacity));
+
+    header = new (base) SharedMemoryHeader();
+    channels = reinterpret_cast<SharedMemoryChannel*>(base + sizeof(SharedMemoryHeader));
+    records = reinterpret_cast<SharedMemoryBarRecord*>(base + sizeof(SharedMemoryHeader) + channelSpecs.size() * sizeof(SharedMemoryChannel));
+
+    for (size_t i = 0; i < channelSpecs.size(); ++i) {
+        SharedMemoryChannel* channel = new (&channels[i]) SharedMemoryChannel();
+        std::strncpy(channel->symbol, channelSpecs[i].first.c_str(), SHARED_MEMORY_SYMBOL_LENGTH - 1);
+        channel->resolution = channelSpecs[i].second;
+    }
+
+    header->headerSize = sizeof(SharedMemoryHeader);
+    header->channelSize = sizeof(SharedMemoryChannel);
+    header->recordSize = sizeof(SharedMemoryBarRecord);
+    header->channelCount = static_cast<uint32_t>(channelSpecs.size());
+    header->ringCapacity = ringCapacity;
+    header->quantityScale = static_cast<uint32_t>(QUANTITY_SCALE);
+    header->createdAt = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    header->version = SHARED_MEMORY_SCHEMA_VERSION;
+
+    // Readers check the magic last, so they never see a half-initialised header.
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHARED_MEMORY_MAGIC;
+}
+
+size_t SharedMemoryBarWriter::requiredSize(size_t channelCount, uint32_t ringCapacity) {
+    return sizeof(SharedMemoryHeader) + channelCount * (sizeof(SharedMemoryChannel) + ringCapacity * sizeof(SharedMemoryBarRecord));
+}
+
+void SharedMemoryBarWriter::publish(size_t channelIndex, const SharedMemoryBarRecord& record) {
+    if (channelIndex >= header->channelCount) {
+        throw std::out_of_range("Shared memory channel out of range");
+    }
+
+    SharedMemoryChannel& channel = channels[channelIndex];
+    const uint64_t sequence = channel.sequence.load(std::memory_order_relaxed);
+    const uint64_t count = channel.count.load(std::memory_order_relaxed);
+
+    channel.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    records[channelIndex * header->ringCapacity + count % header->ringCapacity] = record;
+    channel.count.store(count + 1, std::memory_order_relaxed);
+
+    channel.sequence.store(sequence + 2, std::memory_order_release);
+    header->writeSequence.fetch_add(1, std::memory_order_release);
+}
+
+SharedMemoryBarReader::SharedMemoryBarReader(const std::string& name)
+    : shm(boost::interprocess::open_only, name.c_str(), boost::interprocess::read_only),
+      region(shm, boost::interprocess::read_only) {
+    attach(region.get_address(), region.get_size());
+}
+
+SharedMemoryBarReader::SharedMemoryBarReader(const void* address, size_t size) {
+    attach(address, size);
+}
+
+void SharedMemoryBarReader::attach(const void* address, size_t size) {
+    const char* base = static_cast<const char*>(address);
+    if (size < sizeof(SharedMemoryHeader)) {
+        throw std::runtime_error("Shared memory segment is smaller than its header");
+    }
+
+    header = reinterpret_cast<const SharedMemoryHeader*>(base);
+    if (header->magic != SHARED_MEMORY_MAGIC) {
+        throw std::runtime_error("Shared memory segment has no real-time bar layout");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->version != SHARED_MEMORY_SCHEMA_VERSION || header->headerSize != sizeof(SharedMemoryHeader) ||
+        header->channelSize != sizeof(SharedMemoryChannel) || header->recordSize != sizeof(SharedMemoryBarRecord)) {
+        throw std::runtime_error("Unsupported shared memory schema version " + std::to_string(header->version));
+    }
+    if (size < SharedMemoryBarWriter::requiredSize(header->channelCount, header->ringCapacity)) {
+        throw std::runtime_error("Shared memory segment is truncated");
+    }
+
+    channels = reinterpret_cast<const SharedMemoryChannel*>(base + sizeof(SharedMemoryHeader));
+    records = reinterpret_cast<const SharedMemoryBarRecord*>(base + sizeof(SharedMemoryHeader) + header->channelCount * sizeof(SharedMemoryChannel));
+}
+
+int SharedMemoryBarReader::findChannel(const std::string& symbol, int resolution) const {
+    for (uint32_t i = 0; i < header->channelCount; ++i) {
+        if (channels[i].resolution == resolution && symbol == std::string(channels[i].symbol, strnlen(channels[i].symbol, SHARED_MEMORY_SYMBOL_LENGTH))) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::vector<SharedMemoryChannelSpec> SharedMemoryBarReader::listChannels() const {
+    std::vector<SharedMemoryChannelSpec> specs;
+    for (uint32_t i = 0; i < header->channelCount; ++i) {
+        specs.emplace_back(std::string(channels[i].symbol, strnlen(channels[i].symbol, SHARED_MEMORY_SYMBOL_LENGTH)), channels[i].resolution);
+    }
+    return specs;
+}
+
+bool SharedMemoryBarReader::latest(size_t channel, SharedMemoryBarRecord& record) const {
+    std::vector<SharedMemoryBarRecord> last = history(channel, 1);
+    if (last.empty()) return false;
+    record = last.front();
+    return true;
+}
+
+std::vector<SharedMemoryBarRecord> SharedMemoryBarReader::history(size_t channelIndex, size_t maxRecords) const {
+    if (channelIndex >= header->channelCount) {
+        throw std::out_of_range("Shared memory channel out of range");
+    }
+
+    const SharedMemoryChannel& channel = channels[channelIndex];
+    const SharedMemoryBarRecord* ring = records + channelIndex * header->ringCapacity;
+    std::vector<SharedMemoryBarRecord> result;
+
+    while (true) {
+        const uint64_t before = channel.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;   // writer in progress
+
+        const uint64_t count = channel.count.load(std::memory_order_relaxed);
+        const uint64_t available = std::min<uint64_t>({count, header->ringCapacity, maxRecords});
+        result.resize(available);
+        for (uint64_t i = 0; i < available; ++i) {
+            result[i] = ring[(count - available + i) % header->ringCapacity];
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (channel.sequence.load(std::memory_order_relaxed) == before) {
+            return result;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "ThreadPool.hpp"
+
+namespace {
+
+bool pinToCpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t workerCount, const std::vector<int>& cpus) {
+    if (!cpus.empty()) workerCount = cpus.size();
+    workerCount = std::max<size_t>(1, workerCount);
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+        if (i < cpus.size() && pinToCpu(workers.back(), cpus[i])) ++pinnedCount;
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    cv.notify_one();
+}
+
+// Queued tasks are still run after the destructor starts, so nothing submitted is lost.
+void ThreadPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+TaskGraph::NodeId TaskGraph::add(std::function<void()> work) {
+    nodes.push_back(std::make_unique<Node>());
+    nodes.back()->work = std::move(work);
+    return nodes.size() - 1;
+}
+
+void TaskGraph::precede(NodeId before, NodeId after) {
+    nodes[before]->successors.push_back(after);
+    ++nodes[after]->predecessors;
+}
+
+void TaskGraph::run(ThreadPool& workers) {
+    if (nodes.empty()) return;
+
+    roots.clear();
+    for (NodeId id = 0; id < nodes.size(); ++id) {
+        nodes[id]->waiting.store(nodes[id]->predecessors, std::memory_order_relaxed);
+        if (nodes[id]->predecessors == 0) roots.push_back(id);
+    }
+    failure = nullptr;
+    pool = &workers;
+    remaining.store(nodes.size(), std::memory_order_release);
+
+    for (NodeId id : roots) {
+        workers.submit([this, id] { execute(id); });
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCV.wait(lock, [this] { return remaining.load(std::memory_order_acquire) == 0; });
+    if (failure) std::rethrow_exception(failure);
+}
+
+// A node that throws still releases its successors so run() always returns.
+void TaskGraph::execute(NodeId id) {
+    Node& node = *nodes[id];
+    try {
+        node.work();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (!failure) failure = std::current_exception();
+    }
+
+    for (NodeId next : node.successors) {
+        if (nodes[next]->waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool->submit([this, next] { execute(next); });
+        }
+    }
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        doneCV.notify_all();
+    }
+}
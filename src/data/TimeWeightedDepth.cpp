@@ -0,0 +1,206 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <algorithm>
+#include "TimeWeightedDepth.hpp"
+
+namespace {
+
+constexpr double NS_PER_SECOND = 1e9;
+
+} // namespace
+
+DepthHistogram::DepthHistogram(const PriceLadder& ladder)
+    : ladder_(ladder), bid(std::max(1, ladder.buckets), 0.0), ask(std::max(1, ladder.buckets), 0.0) {}
+
+void DepthHistogram::centre(int64_t bucket) {
+    if (placed) return;
+    base = bucket - static_cast<int64_t>(bid.size()) / 2;
+    placed = true;
+}
+
+void DepthHistogram::add(BookSide side, int64_t bucket, double sizeSeconds) {
+    centre(bucket);
+    const int64_t index = bucket - base;
+    if (index < 0 || index >= static_cast<int64_t>(bid.size())) {
+        outsideSizeSeconds += sizeSeconds;
+        return;
+    }
+
+    (side == BookSide::Bid ? bid : ask)[index] += sizeSeconds;
+    if (used++ == 0) {
+        low = high = index;
+    } else {
+        low = std::min(low, index);
+        high = std::max(high, index);
+    }
+}
+
+void DepthHistogram::merge(const DepthHistogram& other) {
+    if (other.placed) {
+        centre(other.base + static_cast<int64_t>(other.bid.size()) / 2);
+    }
+    if (!other.empty()) {
+        for (int64_t bucket = other.firstBucket(); bucket <= other.lastBucket(); ++bucket) {
+            const double bidValue = other.bidSizeSeconds(bucket);
+            const double askValue = other.askSizeSeconds(bucket);
+            if (bidValue != 0.0) add(BookSide::Bid, bucket, bidValue);
+            if (askValue != 0.0) add(BookSide::Ask, bucket, askValue);
+        }
+    }
+    outsideSizeSeconds += other.outsideSizeSeconds;
+    seconds += other.seconds;
+}
+
+void DepthHistogram::clear() {
+    if (used > 0) {
+        std::fill(bid.begin() + low, bid.begin() + high + 1, 0.0);
+        std::fill(ask.begin() + low, ask.begin() + high + 1, 0.0);
+    }
+    low = 0;
+    high = -1;
+    used = 0;
+    placed = false;
+    seconds = 0.0;
+    outsideSizeSeconds = 0.0;
+}
+
+TimeWeightedDepth::TimeWeightedDepth(const PriceLadder& ladder)
+    : ladder(ladder), resting{std::vector<Resting>(std::max(1, ladder.buckets)), std::vector<Resting>(std::max(1, ladder.buckets))},
+      accumulated(ladder) {}
+
+bool TimeWeightedDepth::apply(OrderBook& book, int position, int operation, int side, double price, Quantity size, int64_t nowNs) {
+    if (position < 0 || position >= OrderBook::MAX_DEPTH || (side != 0 && side != 1)) {
+        return false;
+    }
+    if (size == UNSET_QUANTITY) size = 0;
+
+    // The row that leaves the book, if any: the one overwritten or deleted at
+    // `position`, or the last row pushed out of a full side by an insert.
+    const BookSide bookSide = static_cast<BookSide>(side);
+    const int depth = book.depth(bookSide);
+    int leaving = -1;
+    if ((operation == static_cast<int>(BookOperation::Update) || operation == static_cast<int>(BookOperation::Delete)) && position < depth) {
+        leaving = position;
+    } else if (operation != static_cast<int>(BookOperation::Delete) && depth == OrderBook::MAX_DEPTH) {
+        leaving = OrderBook::MAX_DEPTH - 1;
+    }
+    const double leavingPrice = leaving >= 0 ? book.price(bookSide, leaving) : 0.0;
+    const Quantity leavingSize = leaving >= 0 ? book.size(bookSide, leaving) : 0;
+
+    if (!book.apply(position, operation, side, price, size)) {
+        return false;
+    }
+
+    if (recentre(book, nowNs)) return true;
+    if (leaving >= 0) change(bookSide, leavingPrice, -leavingSize, nowNs);
+    if (operation != static_cast<int>(BookOperation::Delete)) change(bookSide, price, size, nowNs);
+    return true;
+}
+
+// Sizes are summed per bucket: the integral is linear in size, so resting
+// levels that share a bucket, or that all lie outside the window, integrate
+// exactly as if they were kept apart.
+void TimeWeightedDepth::change(BookSide side, double price, Quantity delta, int64_t nowNs) {
+    if (price == 0.0 || delta == 0) return;
+    if (lastFlush == 0) lastFlush = nowNs;   // the first interval starts with the first level
+
+    const int64_t key = ladder.bucketOf(price);
+    auto& levels = resting[static_cast<int>(side)];
+    const int64_t index = key - base;
+    const bool inside = index >= 0 && index < static_cast<int64_t>(levels.size());
+    Resting& level = inside ? levels[index] : outside[static_cast<int>(side)];
+    integrate(side, key, level, nowNs);
+    level.size += delta;
+}
+
+void TimeWeightedDepth::integrate(BookSide side, int64_t bucket, Resting& level, int64_t nowNs) {
+    if (level.size != 0 && nowNs > level.since) {
+        const double sizeSeconds = quantityToDouble(level.size) * (nowNs - level.since) / NS_PER_SECOND;
+        if (&level == &outside[static_cast<int>(side)]) {
+            accumulated.outsideSizeSeconds += sizeSeconds;
+        } else {
+            accumulated.centre(base + static_cast<int64_t>(resting[0].size()) / 2);
+            accumulated.add(side, bucket, sizeSeconds);
+        }
+    }
+    level.since = nowNs;
+}
+
+void TimeWeightedDepth::integrateAll(int64_t nowNs) {
+    for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+        auto& levels = resting[static_cast<int>(side)];
+        for (size_t index = 0; index < levels.size(); ++index) {
+            integrate(side, base + static_cast<int64_t>(index), levels[index], nowNs);
+        }
+        integrate(side, 0, outside[static_cast<int>(side)], nowNs);
+    }
+}
+
+bool TimeWeightedDepth::recentre(const OrderBook& book, int64_t nowNs) {
+    int64_t touch;
+    if (book.depth(BookSide::Bid) > 0) {
+        touch = ladder.bucketOf(book.price(BookSide::Bid, 0));
+    } else if (book.depth(BookSide::Ask) > 0) {
+        touch = ladder.bucketOf(book.price(BookSide::Ask, 0));
+    } else {
+        return false;
+    }
+    const int64_t width = static_cast<int64_t>(resting[0].size());
+    if (anchored && touch - base >= width / 4 && touch - base < width - width / 4) {
+        return false;
+    }
+
+    // Everything held so far is integrated up to now, so the window can be
+    // refilled from the book as if every level had just arrived.
+    integrateAll(nowNs);
+    if (lastFlush == 0) lastFlush = nowNs;
+    base = touch - width / 2;
+    anchored = true;
+    for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+        auto& levels = resting[static_cast<int>(side)];
+        std::fill(levels.begin(), levels.end(), Resting{0, nowNs});
+        outside[static_cast<int>(side)] = Resting{0, nowNs};
+        for (int row = 0; row < book.depth(side); ++row) {
+            const int64_t index = ladder.bucketOf(book.price(side, row)) - base;
+            Resting& level = index >= 0 && index < width ? levels[index] : outside[static_cast<int>(side)];
+            level.size += book.size(side, row);
+        }
+    }
+    return true;
+}
+
+void TimeWeightedDepth::flush(int64_t nowNs) {
+    integrateAll(nowNs);
+    if (lastFlush != 0 && nowNs > lastFlush) {
+        accumulated.seconds += (nowNs - lastFlush) / NS_PER_SECOND;
+    }
+    lastFlush = nowNs;
+}
+
+void TimeWeightedDepth::reset(int64_t nowNs) {
+    flush(nowNs);
+    for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+        std::fill(resting[static_cast<int>(side)].begin(), resting[static_cast<int>(side)].end(), Resting{0, nowNs});
+        outside[static_cast<int>(side)] = Resting{0, nowNs};
+    }
+    anchored = false;
+}
@@ -0,0 +1,170 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "EClientSocket.h"
+#include "EDecoder.h"
+#include "EWrapper.h"
+#include "Clock.hpp"
+#include "TwsJournal.hpp"
+
+// Same limit as the IB client (EClient.h MAX_MSG_LEN); larger frames mean a corrupt journal.
+constexpr uint32_t MAX_JOURNAL_FRAME = 0xFFFFFF;
+
+TwsJournalWriter::TwsJournalWriter(const std::string& path)
+    : out(path, std::ios::binary | std::ios::trunc), startedAt(std::chrono::steady_clock::now()) {
+    if (!out) {
+        throw std::runtime_error("Failed to open TWS journal " + path);
+    }
+
+    int64_t startedAtNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    out.write(TWS_JOURNAL_MAGIC, sizeof(TWS_JOURNAL_MAGIC));
+    out.write(reinterpret_cast<const char*>(&TWS_JOURNAL_VERSION), sizeof(TWS_JOURNAL_VERSION));
+    out.write(reinterpret_cast<const char*>(&startedAtNs), sizeof(startedAtNs));
+}
+
+TwsJournalWriter::~TwsJournalWriter() {
+    std::lock_guard<std::mutex> lock(mutex);
+    out.flush();
+}
+
+std::string TwsJournalWriter::timestampedPath(const std::string& prefix) {
+    std::tm localTime;
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    localtime_r(&now, &localTime);
+    std::ostringstream path;
+    path << prefix << "_" << std::put_time(&localTime, "%Y%m%d-%H%M%S") << ".stxj";
+    return path.str();
+}
+
+void TwsJournalWriter::attach(EClientSocket& client) {
+    client.setReceiveTap(&TwsJournalWriter::onReceive, this);
+}
+
+void TwsJournalWriter::detach(EClientSocket& client) {
+    client.setReceiveTap(nullptr, nullptr);
+}
+
+void TwsJournalWriter::onReceive(void* context, const char* data, int size) {
+    static_cast<TwsJournalWriter*>(context)->append(data, size);
+}
+
+void TwsJournalWriter::append(const char* data, int size) {
+    if (size <= 0) return;
+
+    int64_t offsetNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startedAt).count();
+    uint32_t length = static_cast<uint32_t>(size);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    out.write(reinterpret_cast<const char*>(&offsetNs), sizeof(offsetNs));
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(data, size);
+    bytes.fetch_add(length, std::memory_order_relaxed);
+}
+
+TwsJournalReplayer::TwsJournalReplayer(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open TWS journal " + path);
+    }
+
+    char magic[sizeof(TWS_JOURNAL_MAGIC)];
+    uint32_t version = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&startedAtNs), sizeof(startedAtNs));
+    if (!in || std::memcmp(magic, TWS_JOURNAL_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a TWS journal: " + path);
+    }
+    if (version != TWS_JOURNAL_VERSION) {
+        throw std::runtime_error("Unsupported TWS journal version " + std::to_string(version));
+    }
+
+    int64_t offsetNs;
+    uint32_t length;
+    while (in.read(reinterpret_cast<char*>(&offsetNs), sizeof(offsetNs)) && in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+        size_t begin = data.size();
+        data.resize(begin + length);
+        if (!in.read(data.data() + begin, length)) {
+            // A capture cut short by a crash keeps every complete record before it.
+            data.resize(begin);
+            break;
+        }
+        chunks.push_back({offsetNs, begin, length});
+        bytes += length;
+    }
+}
+
+std::chrono::system_clock::time_point TwsJournalReplayer::startTime() const {
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(startedAtNs)));
+}
+
+size_t TwsJournalReplayer::replay(EWrapper* wrapper, double speed, const std::atomic<bool>& running, SimulatedClock* clock) const {
+    // Server version 0 makes the decoder parse the handshake first, exactly like a fresh connection.
+    EDecoder decoder(0, wrapper);
+    std::vector<char> pending;
+    size_t consumed = 0;
+    size_t messages = 0;
+    const auto replayStart = std::chrono::steady_clock::now();
+
+    for (const Chunk& chunk : chunks) {
+        if (!running.load()) break;
+
+        if (speed > 0.0) {
+            auto due = replayStart + std::chrono::nanoseconds(static_cast<int64_t>(chunk.offsetNs / speed));
+            std::this_thread::sleep_until(due);
+        }
+        if (clock) {
+            clock->advanceTo(startTime() + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(chunk.offsetNs)));
+        }
+
+        pending.insert(pending.end(), data.begin() + chunk.begin, data.begin() + chunk.begin + chunk.size);
+
+        while (pending.size() - consumed >= sizeof(uint32_t)) {
+            uint32_t frameSize;
+            std::memcpy(&frameSize, pending.data() + consumed, sizeof(frameSize));
+            frameSize = ntohl(frameSize);
+            if (frameSize == 0 || frameSize > MAX_JOURNAL_FRAME) {
+                throw std::runtime_error("Corrupt frame in TWS journal at byte " + std::to_string(chunk.begin));
+            }
+            if (pending.size() - consumed < sizeof(uint32_t) + frameSize) break;
+
+            const char* begin = pending.data() + consumed + sizeof(uint32_t);
+            decoder.parseAndProcessMsg(begin, begin + frameSize);
+            consumed += sizeof(uint32_t) + frameSize;
+            ++messages;
+        }
+
+        // Compact once the unread tail is small compared to what was decoded.
+        if (consumed > 0 && consumed >= pending.size() / 2) {
+            pending.erase(pending.begin(), pending.begin() + consumed);
+            consumed = 0;
+        }
+    }
+
+    return messages;
+}
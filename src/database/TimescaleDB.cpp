@@ -19,14 +19,37 @@
  * Date: 2024
  *************************************************************************/
 
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 #include <thread>
 #include "nlohmann/json.hpp"
 #include "TimescaleDB.hpp"
 
 using json = nlohmann::json;
 
-TimescaleDB::TimescaleDB(const std::shared_ptr<Logger>& log, const std::string &_dbname, const std::string &_user, const std::string &_password, const std::string &_host, const std::string &_port)
-    : logger(log), conn(nullptr), dbname(_dbname), user(_user), password(_password), host(_host), port(_port), running(true) {
+// Prepared statements, created per connection by prepareStatements().
+constexpr const char* STMT_MERGE_BARS_STAGING = "merge_bars_staging";
+constexpr const char* STMT_MERGE_DEPTH_STAGING = "merge_depth_staging";
+constexpr const char* STMT_UPSERT_DAILY = "upsert_daily";
+constexpr const char* STMT_MERGE_DAILY_STAGING = "merge_daily_staging";
+constexpr const char* STMT_LAST_DAILY_DATE = "last_daily_date";
+constexpr const char* STMT_FIRST_DAILY_DATE = "first_daily_date";
+constexpr const char* STMT_DAILY_TABLE_EXISTS = "daily_table_exists";
+constexpr const char* STMT_RECENT_DAILY = "recent_daily";
+
+constexpr int POOL_CHECKOUT_TIMEOUT_S = 30;
+constexpr int POOL_HEALTH_CHECK_INTERVAL_S = 30;
+constexpr int POOL_STATS_INTERVAL_S = 60;
+
+TimescaleDB::TimescaleDB(const std::shared_ptr<Logger>& log, const std::string &_dbname, const std::string &_user, const std::string &_password, const std::string &_host, const std::string &_port, size_t poolSize)
+    : logger(log), dbname(_dbname), user(_user), password(_password), host(_host), port(_port), running(true),
+      slots(std::max<size_t>(1, poolSize)), poolStart(std::chrono::steady_clock::now()) {
+    // Reversed so slot 0, opened below, is on top of the stack.
+    for (size_t slot = slots.size(); slot > 0; --slot) {
+        idle.push_back(slot - 1);
+    }
+    stats.size = slots.size();
     try {
         connectToDatabase();
         monitoringThread = std::thread(&TimescaleDB::checkAndReconnect, this);
@@ -48,33 +71,169 @@ void TimescaleDB::stop() {
     }
 
     running.store(false);
-    cv.notify_all();
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> lock(cvMutex);
+        cv.notify_all();
+    }
 
     if (monitoringThread.joinable()) monitoringThread.join();
 
     STX_LOGI(logger, "Cleaning up resources before exit...");
-    if (conn) {
-        conn.reset();
+    logPoolStats();
+    {
+        // Leases returned within the timeout are closed with the idle slots; a
+        // connection still checked out after it stays open until destruction.
+        std::unique_lock<std::mutex> lock(poolMutex);
+        poolCV.notify_all();
+        poolCV.wait_for(lock, std::chrono::seconds(POOL_CHECKOUT_TIMEOUT_S), [this] { return stats.inUse == 0; });
+        for (size_t slot : idle) {
+            slots[slot].conn.reset();
+        }
     }
-    std::this_thread::sleep_for(std::chrono::seconds(1));
     STX_LOGI(logger, "Resources cleaned up and exit.");
 }
 
+// Opens slot 0 and sets up the schema on it; the other slots connect on first checkout.
 void TimescaleDB::connectToDatabase() {
     std::string connectionString = "dbname=" + dbname + " user=" + user + " password=" + password + " host=" + host + " port=" + port;
-    conn = std::make_unique<pqxx::connection>(connectionString);
+    auto conn = std::make_unique<pqxx::connection>(connectionString);
 
     if (conn->is_open()) {
-        STX_LOGI(logger, "Connected to TimescaleDB: " + dbname);
-        enableTimescaleExtension();
-        createTables();
+        STX_LOGI(logger, "Connected to TimescaleDB: " + dbname + " (pool of " + std::to_string(slots.size()) + " connections)");
+        enableTimescaleExtension(*conn);
+        createTables(*conn);
+        // Without its prepared statements the connection is useless to the
+        // pool; slot 0 then stays empty and is opened again on first checkout.
+        try {
+            prepareStatements(*conn);
+        } catch (const std::exception &e) {
+            STX_LOGE(logger, "Error preparing statements in TimescaleDB: " + std::string(e.what()));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(poolMutex);
+        slots[0].conn = std::move(conn);
     } else {
         STX_LOGE(logger, "Failed to connect to TimescaleDB: " + dbname);
         cleanupAndExit();
     }
 }
 
+// A pooled connection only needs its prepared statements; the schema exists already.
+std::unique_ptr<pqxx::connection> TimescaleDB::openConnection() {
+    std::string connectionString = "dbname=" + dbname + " user=" + user + " password=" + password + " host=" + host + " port=" + port;
+    auto conn = std::make_unique<pqxx::connection>(connectionString);
+    prepareStatements(*conn);
+    return conn;
+}
+
+TimescaleDB::Lease::Lease(TimescaleDB& _owner, size_t _slot)
+    : owner(&_owner), slot(_slot), since(std::chrono::steady_clock::now()) {}
+
+TimescaleDB::Lease::Lease(Lease&& other) noexcept
+    : owner(other.owner), slot(other.slot), since(other.since) {
+    other.owner = nullptr;
+}
+
+TimescaleDB::Lease::~Lease() {
+    if (owner) owner->release(slot, since);
+}
+
+TimescaleDB::Lease TimescaleDB::acquire() {
+    const auto start = std::chrono::steady_clock::now();
+    size_t slot;
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        if (idle.empty()) {
+            ++stats.waits;
+            poolCV.wait_for(lock, std::chrono::seconds(POOL_CHECKOUT_TIMEOUT_S), [this] { return !idle.empty() || !running.load(); });
+            if (idle.empty()) {
+                throw std::runtime_error("No database connection available after " + std::to_string(POOL_CHECKOUT_TIMEOUT_S) + "s");
+            }
+        }
+        slot = idle.back();
+        idle.pop_back();
+
+        const double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ++stats.checkouts;
+        stats.totalWaitMs += waitMs;
+        stats.maxWaitMs = std::max(stats.maxWaitMs, waitMs);
+        stats.highWater = std::max(stats.highWater, ++stats.inUse);
+    }
+
+    // From here the slot goes back to the pool however this call ends.
+    Lease lease(*this, slot);
+    if (!slots[slot].conn || !slots[slot].conn->is_open()) {
+        slots[slot].conn = openConnection();
+        std::lock_guard<std::mutex> lock(poolMutex);
+        ++stats.reconnects;
+    }
+    return lease;
+}
+
+void TimescaleDB::release(size_t slot, std::chrono::steady_clock::time_point since) {
+    // The slot is still exclusively ours, so a broken connection is closed outside the lock.
+    if (slots[slot].conn && !slots[slot].conn->is_open()) {
+        slots[slot].conn.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        idle.push_back(slot);
+        --stats.inUse;
+        busyTime += std::chrono::steady_clock::now() - since;
+    }
+    poolCV.notify_one();
+}
+
+TimescaleDB::PoolStats TimescaleDB::getPoolStats() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    PoolStats snapshot = stats;
+    const auto elapsed = std::chrono::steady_clock::now() - poolStart;
+    snapshot.utilization = elapsed.count() > 0 ? static_cast<double>(busyTime.count()) / (static_cast<double>(elapsed.count()) * slots.size()) : 0.0;
+    return snapshot;
+}
+
+void TimescaleDB::logPoolStats() {
+    PoolStats pool = getPoolStats();
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "Database pool: " << pool.inUse << "/" << pool.size << " in use, high water " << pool.highWater
+        << ", checkouts " << pool.checkouts << ", waited " << pool.waits
+        << ", avg wait " << (pool.checkouts > 0 ? pool.totalWaitMs / pool.checkouts : 0.0) << " ms, max wait " << pool.maxWaitMs
+        << " ms, utilization " << pool.utilization * 100.0 << "%, reconnects " << pool.reconnects
+        << ", failed health checks " << pool.failedHealthChecks;
+    STX_LOGI(logger, oss.str());
+}
+
+// Pings every idle connection. One that fails is dropped, and its slot
+// reconnects on its next checkout instead of failing a caller first.
+void TimescaleDB::checkPoolHealth() {
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            auto it = std::find(idle.begin(), idle.end(), slot);
+            if (it == idle.end() || !slots[slot].conn) continue;   // busy, or not connected yet
+            idle.erase(it);
+        }
+
+        bool healthy = false;
+        try {
+            pqxx::nontransaction txn(*slots[slot].conn);
+            txn.exec("SELECT 1;");
+            healthy = true;
+        } catch (const std::exception &e) {
+            STX_LOGW(logger, "Database connection " + std::to_string(slot) + " failed its health check: " + std::string(e.what()));
+        }
+        if (!healthy) slots[slot].conn.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!healthy) ++stats.failedHealthChecks;
+            idle.push_back(slot);
+        }
+        poolCV.notify_one();
+    }
+}
+
 void TimescaleDB::createDatabase(const std::string &dbname, const std::string &user, const std::string &password, const std::string &host, const std::string &port) {
     try {
         STX_LOGI(logger, "Attempting to create database: " + dbname);
@@ -99,10 +258,10 @@ void TimescaleDB::createDatabase(const std::string &dbname, const std::string &u
     }
 }
 
-void TimescaleDB::enableTimescaleExtension() {
+void TimescaleDB::enableTimescaleExtension(pqxx::connection& conn) {
     STX_LOGI(logger, "Attempting to enable TimescaleDB extension.");
     try {
-        pqxx::work txn(*conn);
+        pqxx::work txn(conn);
         txn.exec("CREATE EXTENSION IF NOT EXISTS timescaledb CASCADE;");
         txn.commit();
         STX_LOGI(logger, "TimescaleDB extension enabled.");
@@ -117,7 +276,6 @@ void TimescaleDB::reconnect(int max_attempts, int delay_seconds) {
     while (attempts < max_attempts) {
         STX_LOGI(logger, "Attempting to reconnect to TimescaleDB. Attempt " + std::to_string(attempts + 1) + " of " + std::to_string(max_attempts));
         try {
-            conn.reset();
             connectToDatabase();
             return;
         } catch (const std::exception &e) {
@@ -130,36 +288,82 @@ void TimescaleDB::reconnect(int max_attempts, int delay_seconds) {
     cleanupAndExit();
 }
 
+// Lost connections are reopened lazily by acquire(); this thread only finds
+// them early and reports the pool metrics.
 void TimescaleDB::checkAndReconnect() {
-    std::mutex cvMutex;
-    std::condition_variable cv;
+    auto nextHealthCheck = std::chrono::steady_clock::now() + std::chrono::seconds(POOL_HEALTH_CHECK_INTERVAL_S);
+    auto nextStats = std::chrono::steady_clock::now() + std::chrono::seconds(POOL_STATS_INTERVAL_S);
 
     while (running.load()) {
         std::unique_lock<std::mutex> lock(cvMutex);
         if (cv.wait_for(lock, std::chrono::seconds(2), [this] { return !running.load(); })) {
             break; // Exit the loop if running is set to false
         }
+        lock.unlock();
 
-        if (!conn || !conn->is_open()) {
-            STX_LOGW(logger, "Database connection lost. Attempting to reconnect...");
-            reconnect(5, 2);
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextHealthCheck) {
+            checkPoolHealth();
+            nextHealthCheck = now + std::chrono::seconds(POOL_HEALTH_CHECK_INTERVAL_S);
+        }
+        if (now >= nextStats) {
+            logPoolStats();
+            nextStats = now + std::chrono::seconds(POOL_STATS_INTERVAL_S);
         }
     }
 }
 
-void TimescaleDB::createTables() {
+void TimescaleDB::createTables(pqxx::connection& conn) {
     STX_LOGI(logger, "Attempting to create or verify tables.");
     try {
-        pqxx::work txn(*conn);
+        pqxx::work txn(conn);
 
+        // Tick and microstructure features are NULL for a bar without ticks or quotes of that kind,
+        // book features for a symbol without an L2 book.
+        txn.exec(R"(
+            CREATE TABLE IF NOT EXISTS realtime_bars (
+                ts TIMESTAMPTZ NOT NULL,
+                symbol TEXT NOT NULL,
+                resolution INTEGER NOT NULL,
+                open DOUBLE PRECISION,
+                high DOUBLE PRECISION,
+                low DOUBLE PRECISION,
+                close DOUBLE PRECISION,
+                volume DOUBLE PRECISION,
+                trade_count BIGINT,
+                weighted_avg_price DOUBLE PRECISION,
+                buy_sell_ratio DOUBLE PRECISION,
+                depth_change DOUBLE PRECISION,
+                implied_liquidity DOUBLE PRECISION,
+                price_momentum DOUBLE PRECISION,
+                trade_density DOUBLE PRECISION,
+                rsi DOUBLE PRECISION,
+                macd DOUBLE PRECISION,
+                vwap DOUBLE PRECISION,
+                tick_trades BIGINT,
+                tick_quotes BIGINT,
+                spread DOUBLE PRECISION,
+                microprice DOUBLE PRECISION,
+                quote_imbalance DOUBLE PRECISION,
+                order_flow_imbalance DOUBLE PRECISION,
+                signed_volume DOUBLE PRECISION,
+                PRIMARY KEY (symbol, resolution, ts)
+            );
+        )");
+        // One row per price-ladder bucket of a bar's depth profile.
         txn.exec(R"(
-            CREATE TABLE IF NOT EXISTS realtime_data (
-                datetime TIMESTAMPTZ PRIMARY KEY,
-                l1_data JSONB,
-                l2_data JSONB,
-                feature_data JSONB
+            CREATE TABLE IF NOT EXISTS realtime_depth (
+                ts TIMESTAMPTZ NOT NULL,
+                symbol TEXT NOT NULL,
+                resolution INTEGER NOT NULL,
+                price DOUBLE PRECISION NOT NULL,
+                bid_size DOUBLE PRECISION,
+                ask_size DOUBLE PRECISION,
+                PRIMARY KEY (symbol, resolution, ts, price)
             );
         )");
+        txn.exec("SELECT create_hypertable('realtime_bars', 'ts', if_not_exists => TRUE);");
+        txn.exec("SELECT create_hypertable('realtime_depth', 'ts', if_not_exists => TRUE);");
 
         txn.exec(R"(
             CREATE TABLE IF NOT EXISTS daily_data (
@@ -188,34 +392,117 @@ void TimescaleDB::createTables() {
     }
 }
 
+// Every statement is parsed and planned once per connection. Each pooled
+// connection, including one reopened after a failure, prepares them when it opens.
+void TimescaleDB::prepareStatements(pqxx::connection& conn) {
+    {
+        // Session tables of insertOrUpdateDailyBatch() and insertRealTimeBars(); they must exist before the merges are prepared.
+        pqxx::nontransaction staging(conn);
+        staging.exec(R"(
+            CREATE TEMP TABLE IF NOT EXISTS daily_staging (
+                seq BIGINT,
+                date DATE,
+                symbol TEXT,
+                open DOUBLE PRECISION,
+                high DOUBLE PRECISION,
+                low DOUBLE PRECISION,
+                close DOUBLE PRECISION,
+                volume DOUBLE PRECISION,
+                adj_close DOUBLE PRECISION,
+                sma DOUBLE PRECISION,
+                ema DOUBLE PRECISION,
+                rsi DOUBLE PRECISION,
+                macd DOUBLE PRECISION,
+                vwap DOUBLE PRECISION,
+                momentum DOUBLE PRECISION
+            ) ON COMMIT DELETE ROWS;
+        )");
+        staging.exec("CREATE TEMP TABLE IF NOT EXISTS bars_staging (LIKE realtime_bars) ON COMMIT DELETE ROWS;");
+        staging.exec("CREATE TEMP TABLE IF NOT EXISTS depth_staging (LIKE realtime_depth) ON COMMIT DELETE ROWS;");
+    }
+
+    conn.prepare(STMT_MERGE_BARS_STAGING, "INSERT INTO realtime_bars SELECT * FROM bars_staging ON CONFLICT DO NOTHING;");
+    conn.prepare(STMT_MERGE_DEPTH_STAGING, "INSERT INTO realtime_depth SELECT * FROM depth_staging ON CONFLICT DO NOTHING;");
+    conn.prepare(STMT_UPSERT_DAILY, R"(
+        INSERT INTO daily_data (date, symbol, open, high, low, close, volume, adj_close, sma, ema, rsi, macd, vwap, momentum)
+        VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14)
+        ON CONFLICT (date, symbol) DO UPDATE SET
+            open = EXCLUDED.open, high = EXCLUDED.high, low = EXCLUDED.low, close = EXCLUDED.close,
+            volume = EXCLUDED.volume, adj_close = EXCLUDED.adj_close, sma = EXCLUDED.sma,
+            ema = EXCLUDED.ema, rsi = EXCLUDED.rsi, macd = EXCLUDED.macd, vwap = EXCLUDED.vwap,
+            momentum = EXCLUDED.momentum;
+    )");
+    // ON CONFLICT cannot touch a row twice in one statement, so duplicates are collapsed first.
+    conn.prepare(STMT_MERGE_DAILY_STAGING, R"(
+        INSERT INTO daily_data (date, symbol, open, high, low, close, volume, adj_close, sma, ema, rsi, macd, vwap, momentum)
+        SELECT DISTINCT ON (date, symbol) date, symbol, open, high, low, close, volume, adj_close, sma, ema, rsi, macd, vwap, momentum
+        FROM daily_staging
+        ORDER BY date, symbol, seq DESC
+        ON CONFLICT (date, symbol) DO UPDATE SET
+            open = EXCLUDED.open, high = EXCLUDED.high, low = EXCLUDED.low, close = EXCLUDED.close,
+            volume = EXCLUDED.volume, adj_close = EXCLUDED.adj_close, sma = EXCLUDED.sma,
+            ema = EXCLUDED.ema, rsi = EXCLUDED.rsi, macd = EXCLUDED.macd, vwap = EXCLUDED.vwap,
+            momentum = EXCLUDED.momentum;
+    )");
+    conn.prepare(STMT_LAST_DAILY_DATE, "SELECT MAX(date) FROM daily_data WHERE symbol = $1;");
+    conn.prepare(STMT_FIRST_DAILY_DATE, "SELECT MIN(date) FROM daily_data WHERE symbol = $1;");
+    conn.prepare(STMT_DAILY_TABLE_EXISTS, "SELECT EXISTS (SELECT FROM information_schema.tables WHERE table_name = 'daily_data');");
+    conn.prepare(STMT_RECENT_DAILY, "SELECT date, close, volume FROM daily_data WHERE symbol = $1 ORDER BY date DESC LIMIT $2;");
+}
+
 void TimescaleDB::cleanupAndExit() {
     STX_LOGI(logger, "Cleaning up resources before exit...");
-    if (conn) {
-        conn.reset();
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        for (size_t slot : idle) {
+            slots[slot].conn.reset();
+        }
     }
     std::this_thread::sleep_for(std::chrono::seconds(1));
     STX_LOGI(logger, "Resources cleaned up. Exiting program due to error.");
     exit(EXIT_FAILURE);
 }
 
-bool TimescaleDB::insertRealTimeData(const std::string &datetime, const json &l1Data, const json &l2Data, const json &featureData) {
-    STX_LOGI(logger, "Inserting real-time data at " + datetime);
+bool TimescaleDB::insertRealTimeBars(const std::vector<RealTimeBar> &bars) {
+    if (bars.empty()) return true;
+    STX_LOGD(logger, "Inserting " + std::to_string(bars.size()) + " real-time bars");
     try {
+        Lease conn = acquire();
         pqxx::work txn(*conn);
 
-        std::string query = "INSERT INTO realtime_data (datetime, l1_data, l2_data, feature_data) VALUES (" +
-                            txn.quote(datetime) + ", " +
-                            txn.quote(l1Data.dump()) + ", " +
-                            txn.quote(l2Data.dump()) + ", " +
-                            txn.quote(featureData.dump()) + ");";
+        size_t levels = 0;
+        {
+            auto stream = pqxx::stream_to::table(txn, {"bars_staging"},
+                {"ts", "symbol", "resolution", "open", "high", "low", "close", "volume", "trade_count",
+                 "weighted_avg_price", "buy_sell_ratio", "depth_change", "implied_liquidity", "price_momentum",
+                 "trade_density", "rsi", "macd", "vwap", "tick_trades", "tick_quotes", "spread",
+                 "microprice", "quote_imbalance", "order_flow_imbalance", "signed_volume"});
+            for (const RealTimeBar &bar : bars) {
+                stream.write_values(bar.datetime, bar.symbol, bar.resolution, bar.open, bar.high, bar.low, bar.close, bar.volume, bar.tradeCount,
+                                    bar.weightedAvgPrice, bar.buySellRatio, bar.depthChange, bar.impliedLiquidity, bar.priceMomentum,
+                                    bar.tradeDensity, bar.rsi, bar.macd, bar.vwap, bar.tickTrades, bar.tickQuotes, bar.spread,
+                                    bar.microprice, bar.quoteImbalance, bar.orderFlowImbalance, bar.signedVolume);
+            }
+            stream.complete();
+        }
+        {
+            auto stream = pqxx::stream_to::table(txn, {"depth_staging"}, {"ts", "symbol", "resolution", "price", "bid_size", "ask_size"});
+            for (const RealTimeBar &bar : bars) {
+                for (const DepthLevel &level : bar.depth) {
+                    stream.write_values(bar.datetime, bar.symbol, bar.resolution, level.price, level.bidSize, level.askSize);
+                }
+                levels += bar.depth.size();
+            }
+            stream.complete();
+        }
 
-        txn.exec(query);
+        txn.exec_prepared(STMT_MERGE_BARS_STAGING);
+        txn.exec_prepared(STMT_MERGE_DEPTH_STAGING);
         txn.commit();
-
-        STX_LOGI(logger, "Inserted real-time data at " + datetime);
+        STX_LOGD(logger, "Inserted " + std::to_string(bars.size()) + " real-time bars with " + std::to_string(levels) + " depth rows");
         return true;
     } catch (const std::exception &e) {
-        STX_LOGE(logger, "Error inserting real-time data into TimescaleDB: " + std::string(e.what()));
+        STX_LOGE(logger, "Error inserting real-time bars into TimescaleDB: " + std::string(e.what()));
         return false;
     }
 }
@@ -223,30 +510,13 @@ bool TimescaleDB::insertRealTimeData(const std::string &datetime, const json &l1
 bool TimescaleDB::insertOrUpdateDailyData(const std::string &date, const std::map<std::string, std::variant<double, std::string>> &dailyData) {
     STX_LOGD(logger, "Inserting or updating daily data for date " + date);
     try {
+        Lease conn = acquire();
         pqxx::work txn(*conn);
 
-        std::string query = "INSERT INTO daily_data (date, symbol, open, high, low, close, volume, adj_close, sma, ema, rsi, macd, vwap, momentum) VALUES (" +
-                            txn.quote(date) + ", " +
-                            txn.quote(std::get<std::string>(dailyData.at("symbol"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("open"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("high"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("low"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("close"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("volume"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("adj_close"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("sma"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("ema"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("rsi"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("macd"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("vwap"))) + ", " +
-                            txn.quote(std::get<double>(dailyData.at("momentum"))) + ") " +
-                            "ON CONFLICT (date, symbol) DO UPDATE SET " +
-                            "open = EXCLUDED.open, high = EXCLUDED.high, low = EXCLUDED.low, close = EXCLUDED.close, " +
-                            "volume = EXCLUDED.volume, adj_close = EXCLUDED.adj_close, sma = EXCLUDED.sma, " +
-                            "ema = EXCLUDED.ema, rsi = EXCLUDED.rsi, macd = EXCLUDED.macd, vwap = EXCLUDED.vwap, " +
-                            "momentum = EXCLUDED.momentum;";
-
-        txn.exec(query);
+        auto field = [&dailyData](const char* name) { return std::get<double>(dailyData.at(name)); };
+        txn.exec_prepared(STMT_UPSERT_DAILY, date, std::get<std::string>(dailyData.at("symbol")),
+                          field("open"), field("high"), field("low"), field("close"), field("volume"), field("adj_close"),
+                          field("sma"), field("ema"), field("rsi"), field("macd"), field("vwap"), field("momentum"));
         txn.commit();
         STX_LOGD(logger, "Inserted or updated " + std::get<std::string>(dailyData.at("symbol")) + " for date " + date);
         return true;
@@ -256,11 +526,37 @@ bool TimescaleDB::insertOrUpdateDailyData(const std::string &date, const std::ma
     }
 }
 
+bool TimescaleDB::insertOrUpdateDailyBatch(const std::vector<DailyBar> &bars) {
+    if (bars.empty()) return true;
+    STX_LOGD(logger, "Inserting or updating " + std::to_string(bars.size()) + " daily bars");
+    try {
+        Lease conn = acquire();
+        pqxx::work txn(*conn);
+
+        auto stream = pqxx::stream_to::table(txn, {"daily_staging"},
+            {"seq", "date", "symbol", "open", "high", "low", "close", "volume", "adj_close", "sma", "ema", "rsi", "macd", "vwap", "momentum"});
+        int64_t seq = 0;
+        for (const DailyBar &bar : bars) {
+            stream.write_values(seq++, bar.date, bar.symbol, bar.open, bar.high, bar.low, bar.close, bar.volume,
+                                bar.adjClose, bar.sma, bar.ema, bar.rsi, bar.macd, bar.vwap, bar.momentum);
+        }
+        stream.complete();
+
+        txn.exec_prepared(STMT_MERGE_DAILY_STAGING);
+        txn.commit();
+        STX_LOGD(logger, "Inserted or updated " + std::to_string(bars.size()) + " daily bars");
+        return true;
+    } catch (const std::exception &e) {
+        STX_LOGE(logger, "Error inserting or updating a daily batch into TimescaleDB: " + std::string(e.what()));
+        return false;
+    }
+}
+
 const std::string TimescaleDB::getLastDailyEndDate(const std::string &symbol) {
     try {
+        Lease conn = acquire();
         pqxx::work txn(*conn);
-        std::string query = "SELECT MAX(date) FROM daily_data WHERE symbol = " + txn.quote(symbol) + ";";
-        pqxx::result result = txn.exec(query);
+        pqxx::result result = txn.exec_prepared(STMT_LAST_DAILY_DATE, symbol);
 
         if (!result.empty() && !result[0][0].is_null()) {
             std::string lastDate = result[0][0].as<std::string>();
@@ -276,9 +572,9 @@ const std::string TimescaleDB::getLastDailyEndDate(const std::string &symbol) {
 
 const std::string TimescaleDB::getFirstDailyStartDate(const std::string &symbol) {
     try {
+        Lease conn = acquire();
         pqxx::work txn(*conn);
-        std::string query = "SELECT MIN(date) FROM daily_data WHERE symbol = " + txn.quote(symbol) + ";";
-        pqxx::result result = txn.exec(query);
+        pqxx::result result = txn.exec_prepared(STMT_FIRST_DAILY_DATE, symbol);
 
         if (!result.empty() && !result[0][0].is_null()) {
             std::string firstDate = result[0][0].as<std::string>();
@@ -296,18 +592,17 @@ std::vector<std::map<std::string, double>> TimescaleDB::getRecentHistoricalData(
     std::vector<std::map<std::string, double>> historicalData;
 
     try {
+        Lease conn = acquire();
         pqxx::work txn(*conn);
         
-        std::string checkTableQuery = "SELECT EXISTS (SELECT FROM information_schema.tables WHERE table_name = 'daily_data');";
-        pqxx::result tableExists = txn.exec(checkTableQuery);
+        pqxx::result tableExists = txn.exec_prepared(STMT_DAILY_TABLE_EXISTS);
         
         if (!tableExists[0][0].as<bool>()) {
             STX_LOGW(logger, "Table 'daily_data' does not exist.");
             return historicalData;  // Return empty vector
         }
 
-        std::string query = "SELECT date, close, volume FROM daily_data WHERE symbol = " + txn.quote(symbol) + " ORDER BY date DESC LIMIT " + std::to_string(period) + ";";
-        pqxx::result result = txn.exec(query);
+        pqxx::result result = txn.exec_prepared(STMT_RECENT_DAILY, symbol, period);
 
         if (result.empty()) {
             STX_LOGW(logger, "No historical data found for symbol: " + symbol);
@@ -194,17 +194,47 @@ int main(int argc, char* argv[]) {
             config.user, 
             config.password, 
             config.host, 
-            config.port
+            config.port,
+            config.poolSize
         );
-        dataCollector = std::make_shared<RealTimeData>(logger, timescaleDB);
+        RealTimeConfig realTimeConfig = loadRealTimeConfig(configFilePath, logger);
+        dataCollector = std::make_shared<RealTimeData>(logger, timescaleDB, realTimeConfig);
         STX_LOGI(logger, "Successfully initialized RealTimeData.");
         historicalDataFetcher = std::make_shared<DailyDataFetcher>(logger, timescaleDB);
         STX_LOGI(logger, "Successfully initialized DailyDataFetcher.");     
+
+        JournalConfig journalConfig = loadJournalConfig(configFilePath, logger);
+        dataCollector->setJournalPath(journalConfig.realtime);
+        historicalDataFetcher->setJournalPath(journalConfig.daily);
     } catch (const std::exception& e) {
         STX_LOGE(logger, "Initialization timescaleDB failed: " + std::string(e.what()));
         return 1;
     }
 
+    // Offline replay of a captured TWS journal:
+    //   OpenSTX <log_level> replay realtime <journal> [speed]
+    //   OpenSTX <log_level> replay daily:<SYMBOL> <journal> [speed]
+    // speed 1 keeps the recorded pace, 0 (default) replays as fast as possible.
+    if (argc >= 5 && std::string(argv[2]) == "replay") {
+        std::string target = argv[3];
+        std::string journalFile = argv[4];
+        double speed = argc >= 6 ? std::stod(argv[5]) : 0.0;
+
+        bool replayed = false;
+        if (target == "realtime") {
+            replayed = dataCollector->replay(journalFile, speed);
+        } else if (target.rfind("daily:", 0) == 0) {
+            replayed = historicalDataFetcher->replay(target.substr(6), journalFile, speed);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " <log_level> replay <realtime|daily:SYMBOL> <journal> [speed]" << std::endl;
+        }
+
+        if (timescaleDB && timescaleDB->isRunning()) {
+            timescaleDB->stop();
+        }
+        return replayed ? 0 : 1;
+    }
+
     std::thread realTimeDataThread([&]() {
         while (running.load()) {
             try {
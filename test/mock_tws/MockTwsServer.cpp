@@ -0,0 +1,417 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "MockTwsServer.hpp"
+
+namespace {
+
+// Outgoing message ids (EDecoder.h) and incoming request ids (EClient.h).
+constexpr int TICK_PRICE = 1;
+constexpr int NEXT_VALID_ID = 9;
+constexpr int MARKET_DEPTH = 12;
+constexpr int MANAGED_ACCTS = 15;
+constexpr int HISTORICAL_DATA = 17;
+
+constexpr int REQ_MKT_DATA = 1;
+constexpr int CANCEL_MKT_DATA = 2;
+constexpr int REQ_IDS = 8;
+constexpr int REQ_MKT_DEPTH = 10;
+constexpr int CANCEL_MKT_DEPTH = 11;
+constexpr int REQ_HISTORICAL_DATA = 20;
+constexpr int START_API = 71;
+
+constexpr int TICK_BID = 1;
+constexpr int TICK_ASK = 2;
+constexpr int TICK_LAST = 4;
+
+constexpr size_t MAX_FRAME = 0xFFFFFF;
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+constexpr uint64_t MAX_BURST_DIVISOR = 10;   // never generate more than 100 ms of backlog at once
+
+std::string formatPrice(double price) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << price;
+    return oss.str();
+}
+
+bool sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd pfd{fd, POLLOUT, 0};
+                ::poll(&pfd, 1, 100);
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+MockTwsServer::MockTwsServer(const MockTwsOptions& _options) : options(_options) {
+    if (options.messagesPerSecond < 0 || options.l2Share < 0.0 || options.l2Share > 1.0 || options.depth <= 0) {
+        throw std::invalid_argument("Invalid mock TWS options");
+    }
+}
+
+void MockTwsServer::run() {
+    listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("socket() failed: " + std::string(std::strerror(errno)));
+    }
+
+    int reuse = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listenFd, 8) < 0) {
+        ::close(listenFd);
+        throw std::runtime_error("Cannot listen on 127.0.0.1:" + std::to_string(options.port) + ": " + std::strerror(errno));
+    }
+
+    running.store(true);
+    std::cout << "Mock TWS listening on 127.0.0.1:" << options.port << ", server version " << options.serverVersion
+              << ", " << options.messagesPerSecond << " msg/s per connection, L2 share " << options.l2Share
+              << ", depth " << options.depth << std::endl;
+
+    std::vector<std::thread> sessions;
+    while (running.load()) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        if (::poll(&pfd, 1, 200) <= 0) continue;
+
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        sessions.emplace_back(&MockTwsServer::serve, this, fd);
+    }
+
+    for (auto& session : sessions) {
+        if (session.joinable()) session.join();
+    }
+    ::close(listenFd);
+    listenFd = -1;
+}
+
+void MockTwsServer::stop() {
+    running.store(false);
+}
+
+void MockTwsServer::serve(int fd) {
+    Session session;
+    session.fd = fd;
+    session.rng.seed(options.seed + static_cast<uint32_t>(fd));
+
+    if (!handshake(session)) {
+        std::cout << "Handshake failed on fd " << fd << std::endl;
+        ::close(fd);
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    auto lastStats = start;
+    uint64_t generated = 0;
+    uint64_t sentAtLastStats = 0;
+    const uint64_t maxBurst = std::max<uint64_t>(1, static_cast<uint64_t>(options.messagesPerSecond) / MAX_BURST_DIVISOR);
+
+    while (running.load()) {
+        bool streaming = !session.l1.empty() || !session.l2.empty();
+
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, streaming ? 1 : 100);
+        if (ready > 0 && !readRequests(session)) break;
+
+        auto now = Clock::now();
+        if (streaming && options.messagesPerSecond > 0) {
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            uint64_t due = static_cast<uint64_t>(elapsed * options.messagesPerSecond);
+            if (due > generated) {
+                // A client that cannot keep up makes send() block; skip the backlog instead of queueing it forever.
+                uint64_t count = std::min(due - generated, maxBurst);
+                generate(session, count);
+                generated = due;
+            }
+        }
+        if (!flush(session)) break;
+
+        if (now - lastStats >= std::chrono::milliseconds(options.statsIntervalMs)) {
+            double seconds = std::chrono::duration<double>(now - lastStats).count();
+            std::cout << "client " << session.clientId << ": " << static_cast<uint64_t>((session.sent - sentAtLastStats) / seconds)
+                      << " msg/s (target " << options.messagesPerSecond << "), L1 " << session.l1.size()
+                      << ", L2 " << session.l2.size() << ", requests " << session.received << std::endl;
+            sentAtLastStats = session.sent;
+            lastStats = now;
+        }
+    }
+
+    std::cout << "client " << session.clientId << " disconnected after " << session.sent << " messages" << std::endl;
+    ::close(fd);
+}
+
+bool MockTwsServer::handshake(Session& session) {
+    // "API\0" followed by one length-prefixed "v<min>..<max>" frame.
+    while (session.inbound.size() < 8) {
+        pollfd pfd{session.fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 5000) <= 0) return false;
+
+        char buffer[256];
+        ssize_t received = ::recv(session.fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) return false;
+        session.inbound.append(buffer, static_cast<size_t>(received));
+    }
+    if (session.inbound.compare(0, 4, std::string("API\0", 4)) != 0) return false;
+
+    uint32_t length;
+    std::memcpy(&length, session.inbound.data() + 4, sizeof(length));
+    length = ntohl(length);
+    while (session.inbound.size() < 8 + length) {
+        char buffer[256];
+        ssize_t received = ::recv(session.fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) return false;
+        session.inbound.append(buffer, static_cast<size_t>(received));
+    }
+    std::cout << "client hello: " << session.inbound.substr(8, length) << std::endl;
+    session.inbound.erase(0, 8 + length);
+
+    std::time_t now = std::time(nullptr);
+    std::tm localTime;
+    localtime_r(&now, &localTime);
+    std::ostringstream connectionTime;
+    connectionTime << std::put_time(&localTime, "%Y%m%d %H:%M:%S") << " EST";
+
+    sendFrame(session, {std::to_string(options.serverVersion), connectionTime.str()});
+    return flush(session);
+}
+
+bool MockTwsServer::readRequests(Session& session) {
+    char buffer[64 * 1024];
+    ssize_t received = ::recv(session.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (received == 0) return false;
+    if (received < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    session.inbound.append(buffer, static_cast<size_t>(received));
+
+    size_t offset = 0;
+    while (session.inbound.size() - offset >= sizeof(uint32_t)) {
+        uint32_t length;
+        std::memcpy(&length, session.inbound.data() + offset, sizeof(length));
+        length = ntohl(length);
+        if (length > MAX_FRAME) return false;
+        if (session.inbound.size() - offset < sizeof(uint32_t) + length) break;
+
+        std::vector<std::string> fields;
+        const char* field = session.inbound.data() + offset + sizeof(uint32_t);
+        const char* end = field + length;
+        while (field < end) {
+            size_t fieldLength = strnlen(field, static_cast<size_t>(end - field));
+            fields.emplace_back(field, fieldLength);
+            field += fieldLength + 1;
+        }
+        offset += sizeof(uint32_t) + length;
+
+        if (!fields.empty()) {
+            ++session.received;
+            handleRequest(session, fields);
+        }
+    }
+    session.inbound.erase(0, offset);
+    return true;
+}
+
+void MockTwsServer::handleRequest(Session& session, const std::vector<std::string>& fields) {
+    auto field = [&fields](size_t index) { return index < fields.size() ? fields[index] : std::string(); };
+    auto intField = [&field](size_t index) { return std::atoi(field(index).c_str()); };
+
+    std::uniform_real_distribution<double> startPrice(50.0, 500.0);
+    switch (intField(0)) {
+        case START_API:
+            session.clientId = intField(2);
+            sendNextValidId(session);
+            sendFrame(session, {std::to_string(MANAGED_ACCTS), "1", "DU0000000"});
+            break;
+        case REQ_IDS:
+            sendNextValidId(session);
+            break;
+        case REQ_MKT_DATA:
+            // msgId, version, tickerId, conId, symbol, ...
+            session.l1[intField(2)] = {intField(2), field(4), std::round(startPrice(session.rng) * 100.0) / 100.0};
+            break;
+        case CANCEL_MKT_DATA:
+            session.l1.erase(intField(2));
+            break;
+        case REQ_MKT_DEPTH: {
+            // msgId, version, tickerId, conId, symbol, ...
+            Subscription book{intField(2), field(4), std::round(startPrice(session.rng) * 100.0) / 100.0};
+            session.l2[book.tickerId] = book;
+            sendInitialBook(session, book);
+            break;
+        }
+        case CANCEL_MKT_DEPTH:
+            session.l2.erase(intField(2));
+            break;
+        case REQ_HISTORICAL_DATA:
+            // msgId, tickerId, conId, symbol, secType, expiry, strike, right, multiplier, exchange,
+            // primaryExchange, currency, localSymbol, tradingClass, includeExpired, endDateTime, ...
+            sendHistoricalData(session, intField(1), field(15));
+            break;
+        default:
+            break;
+    }
+}
+
+void MockTwsServer::generate(Session& session, uint64_t count) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> step(0.0, 0.01);
+    std::uniform_int_distribution<int> size(1, 1000);
+    std::uniform_int_distribution<int> position(0, options.depth - 1);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        bool depthUpdate = !session.l2.empty() && (session.l1.empty() || unit(session.rng) < options.l2Share);
+        std::map<int, Subscription>& subscriptions = depthUpdate ? session.l2 : session.l1;
+
+        auto it = subscriptions.begin();
+        std::advance(it, std::uniform_int_distribution<size_t>(0, subscriptions.size() - 1)(session.rng));
+        Subscription& subscription = it->second;
+        subscription.mid = std::max(0.01, subscription.mid + step(session.rng));
+
+        if (depthUpdate) {
+            int row = position(session.rng);
+            int side = unit(session.rng) < 0.5 ? 0 : 1;
+            double price = subscription.mid + (side == 0 ? 1 : -1) * (row + 1) * 0.01;
+            sendFrame(session, {std::to_string(MARKET_DEPTH), "1", std::to_string(subscription.tickerId), std::to_string(row), "1",
+                                std::to_string(side), formatPrice(price), std::to_string(size(session.rng))});
+        } else {
+            double draw = unit(session.rng);
+            int tickType = draw < 0.5 ? TICK_LAST : (draw < 0.75 ? TICK_BID : TICK_ASK);
+            double price = subscription.mid + (tickType == TICK_BID ? -0.01 : (tickType == TICK_ASK ? 0.01 : 0.0));
+            sendFrame(session, {std::to_string(TICK_PRICE), "6", std::to_string(subscription.tickerId), std::to_string(tickType),
+                                formatPrice(price), std::to_string(size(session.rng)), "0"});
+        }
+        ++session.sent;
+
+        if (session.outbound.size() >= FLUSH_THRESHOLD && !flush(session)) return;
+    }
+}
+
+bool MockTwsServer::flush(Session& session) {
+    if (session.outbound.empty()) return true;
+    bool ok = sendAll(session.fd, session.outbound.data(), session.outbound.size());
+    session.outbound.clear();
+    return ok;
+}
+
+void MockTwsServer::sendFrame(Session& session, const std::vector<std::string>& fields) {
+    size_t lengthOffset = session.outbound.size();
+    session.outbound.append(sizeof(uint32_t), '\0');
+    for (const auto& field : fields) {
+        session.outbound.append(field);
+        session.outbound.push_back('\0');
+    }
+    uint32_t length = htonl(static_cast<uint32_t>(session.outbound.size() - lengthOffset - sizeof(uint32_t)));
+    std::memcpy(&session.outbound[lengthOffset], &length, sizeof(length));
+}
+
+void MockTwsServer::sendNextValidId(Session& session) {
+    sendFrame(session, {std::to_string(NEXT_VALID_ID), "1", std::to_string(nextOrderId.fetch_add(1))});
+}
+
+void MockTwsServer::sendInitialBook(Session& session, const Subscription& book) {
+    std::uniform_int_distribution<int> size(1, 1000);
+    for (int side = 0; side < 2; ++side) {
+        for (int row = 0; row < options.depth; ++row) {
+            double price = book.mid + (side == 0 ? 1 : -1) * (row + 1) * 0.01;
+            sendFrame(session, {std::to_string(MARKET_DEPTH), "1", std::to_string(book.tickerId), std::to_string(row), "0",
+                                std::to_string(side), formatPrice(price), std::to_string(size(session.rng))});
+            ++session.sent;
+        }
+    }
+}
+
+void MockTwsServer::sendHistoricalData(Session& session, int reqId, const std::string& endDateTime) {
+    std::tm endDate{};
+    std::istringstream iss(endDateTime.substr(0, 8));
+    iss >> std::get_time(&endDate, "%Y%m%d");
+    if (iss.fail()) {
+        std::time_t now = std::time(nullptr);
+        localtime_r(&now, &endDate);
+    }
+    endDate.tm_hour = 12;
+
+    std::uniform_real_distribution<double> startPrice(50.0, 500.0);
+    std::normal_distribution<double> change(0.0, 0.01);
+    std::uniform_int_distribution<int> volume(100000, 10000000);
+    double close = startPrice(session.rng);
+
+    std::vector<std::string> bars;
+    std::string firstDate, lastDate;
+    for (int i = options.historyBars - 1; i >= 0; --i) {
+        std::tm day = endDate;
+        day.tm_mday -= i;
+        std::mktime(&day);
+        std::ostringstream date;
+        date << std::put_time(&day, "%Y%m%d");
+        if (firstDate.empty()) firstDate = date.str();
+        lastDate = date.str();
+
+        double open = close;
+        close = std::max(0.01, open * (1.0 + change(session.rng)));
+        double high = std::max(open, close) * 1.005;
+        double low = std::min(open, close) * 0.995;
+        // time, open, high, low, close, volume, wap, count
+        for (const std::string& value : {date.str(), formatPrice(open), formatPrice(high), formatPrice(low), formatPrice(close),
+                                         std::to_string(volume(session.rng)), formatPrice((open + close) / 2.0), std::string("1000")}) {
+            bars.push_back(value);
+        }
+    }
+
+    // Server versions >= 124 send neither the message version nor the hasGaps flag.
+    std::vector<std::string> fields{std::to_string(HISTORICAL_DATA), std::to_string(reqId), firstDate, lastDate, std::to_string(options.historyBars)};
+    fields.insert(fields.end(), bars.begin(), bars.end());
+    sendFrame(session, fields);
+    ++session.sent;
+}
@@ -0,0 +1,93 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#ifndef MOCK_TWS_SERVER_H
+#define MOCK_TWS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Stand-in for TWS/IB Gateway that speaks just enough of the V100+ socket
+// protocol for EClientSocket: the "API\0" handshake, startApi, reqIds,
+// reqMktData, reqMktDepth, reqHistoricalData and their cancels. Market data is
+// synthetic: a random walk per subscription, L1 as LAST price/size pairs plus
+// BID/ASK updates, L2 as row updates of a fixed-depth book.
+struct MockTwsOptions {
+    int port = 7496;
+    int serverVersion = 176;         // anything in the client's [MIN_CLIENT_VER, MAX_CLIENT_VER]
+    double messagesPerSecond = 10000; // per connection, L1 + L2 together
+    double l2Share = 0.8;            // fraction of the messages that are depth updates
+    int depth = 10;                  // rows per book side
+    int historyBars = 1;             // bars answered per reqHistoricalData
+    int statsIntervalMs = 1000;
+    uint32_t seed = 42;
+};
+
+class MockTwsServer {
+public:
+    explicit MockTwsServer(const MockTwsOptions& options);
+
+    // Accepts connections until stop() is called; each one is served on its own thread.
+    void run();
+    void stop();
+
+private:
+    struct Subscription {
+        int tickerId;
+        std::string symbol;
+        double mid;
+    };
+
+    struct Session {
+        int fd;
+        int clientId = -1;
+        std::string inbound;
+        std::string outbound;
+        std::map<int, Subscription> l1;
+        std::map<int, Subscription> l2;
+        std::mt19937 rng;
+        uint64_t sent = 0;
+        uint64_t received = 0;
+    };
+
+    void serve(int fd);
+    bool handshake(Session& session);
+    bool readRequests(Session& session);
+    void handleRequest(Session& session, const std::vector<std::string>& fields);
+    void generate(Session& session, uint64_t count);
+    bool flush(Session& session);
+
+    void sendFrame(Session& session, const std::vector<std::string>& fields);
+    void sendNextValidId(Session& session);
+    void sendInitialBook(Session& session, const Subscription& book);
+    void sendHistoricalData(Session& session, int reqId, const std::string& endDateTime);
+
+    MockTwsOptions options;
+    std::atomic<bool> running{false};
+    int listenFd = -1;
+    std::atomic<int> nextOrderId{1};
+};
+
+#endif // MOCK_TWS_SERVER_H
@@ -0,0 +1,80 @@
+/**************************************************************************
+ * This file is part of the OpenSTX project.
+ *
+ * OpenSTX (Open Smart Trading eXpert) is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenSTX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenSTX. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Ailven.LIU
+ * Email: ailven.x.liu@gmail.com
+ * Date: 2024
+ *************************************************************************/
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "MockTwsServer.hpp"
+
+static MockTwsServer* server = nullptr;
+
+static void signalHandler(int) {
+    if (server) server->stop();
+}
+
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--port 7496] [--rate 10000] [--l2-share 0.8] [--depth 10]"
+              << " [--history-bars 1] [--server-version 176] [--seed 42]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    MockTwsOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--port") options.port = std::stoi(value);
+            else if (arg == "--rate") options.messagesPerSecond = std::stod(value);
+            else if (arg == "--l2-share") options.l2Share = std::stod(value);
+            else if (arg == "--depth") options.depth = std::stoi(value);
+            else if (arg == "--history-bars") options.historyBars = std::stoi(value);
+            else if (arg == "--server-version") options.serverVersion = std::stoi(value);
+            else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        MockTwsServer mock(options);
+        server = &mock;
+        std::signal(SIGINT, signalHandler);
+        std::signal(SIGTERM, signalHandler);
+        mock.run();
+        server = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "BarEngine.hpp"
+#include "BarPayload.hpp"
+#include "Clock.hpp"
+
+namespace {
+
+int64_t epochSecond(const Clock& clock) {
+    return std::chrono::duration_cast<std::chrono::seconds>(clock.now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// 测试周期延误跳过分钟边界时，分钟 bar 收盘后逐 bar 累积量仍被清空
+TEST(TEST_BarSeries, LateCycleAcrossMinuteStillResets) {
+    SimulatedClock clock(Clock::TimePoint(std::chrono::seconds(1200)));
+    BarEngine engine({1, 60});
+    BarSeries minute;
+    minute.seconds = 60;
+    int minuteBars = 0;
+    auto cycle = [&]() {
+        engine.advance(epochSecond(clock), [&](size_t level, int64_t boundary, const OhlcvBar&) {
+            if (level == 1) {
+                EXPECT_EQ(boundary, 1260);
+                ++minuteBars;
+            }
+        });
+        minute.rollAccumulators(epochSecond(clock));
+    };
+    cycle();
+
+    // 1230 秒：一笔成交，累积量记下这根分钟 bar 的活动
+    clock.advanceTo(Clock::TimePoint(std::chrono::seconds(1230)));
+    engine.onPrice(100.0);
+    engine.onSize(QUANTITY_SCALE);
+    cycle();
+    minute.ticks.trades = 3;
+    minute.micro.addTrade(1, QUANTITY_SCALE);
+    minute.depth.add(BookSide::Bid, minute.depth.ladder().bucketOf(100.0), 1.0);
+
+    // 下一次唤醒已到 1261 秒，1260 这一秒没有周期
+    clock.advanceTo(Clock::TimePoint(std::chrono::seconds(1261)));
+    cycle();
+    EXPECT_EQ(minuteBars, 1);
+    EXPECT_TRUE(minute.ticks.empty());
+    EXPECT_TRUE(minute.micro.empty());
+    EXPECT_TRUE(minute.depth.empty());
+
+    // 同一根 bar 内不再清空
+    minute.ticks.trades = 2;
+    clock.advanceTo(Clock::TimePoint(std::chrono::seconds(1290)));
+    cycle();
+    EXPECT_EQ(minute.ticks.trades, 2u);
+}
+
+// 测试夏令时回拨时本地时间重复的两个边界写成不同的 UTC 时间
+TEST(TEST_BarSeries, UtcTimestampSurvivesRepeatedLocalHour) {
+    const char* previous = std::getenv("TZ");
+    const std::string saved = previous ? previous : "";
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+
+    // 2024-11-03 01:30 本地时间出现两次：先 EDT 后 EST
+    const int64_t first = 1730611800;
+    const int64_t second = first + 3600;
+    auto local = [](int64_t epochSecond) {
+        const std::time_t time = static_cast<std::time_t>(epochSecond);
+        std::tm tm;
+        localtime_r(&time, &tm);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        return std::string(buffer);
+    };
+    EXPECT_EQ(local(first), local(second));
+    EXPECT_EQ(utcTimestamp(first), "2024-11-03 05:30:00+00");
+    EXPECT_EQ(utcTimestamp(second), "2024-11-03 06:30:00+00");
+
+    if (previous) setenv("TZ", saved.c_str(), 1); else unsetenv("TZ");
+    tzset();
+}
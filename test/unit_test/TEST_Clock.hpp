@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Clock.hpp"
+
+// 测试 SimulatedClock 不推进时只在真实超时后返回
+TEST(TEST_Clock, SimulatedWaitTimesOutWithoutAdvance) {
+    SimulatedClock clock(Clock::TimePoint(std::chrono::seconds(1000)));
+    EXPECT_FALSE(clock.waitUntil(clock.now() + std::chrono::seconds(1), std::chrono::milliseconds(5)));
+    EXPECT_EQ(clock.now(), Clock::TimePoint(std::chrono::seconds(1000)));
+}
+
+// 测试 advanceTo 等到挂载线程处理完到期的工作才返回
+TEST(TEST_Clock, AdvanceWaitsForAttachedThreads) {
+    SimulatedClock clock(Clock::TimePoint(std::chrono::seconds(1000)));
+    std::atomic<bool> running{true};
+    std::atomic<int> boundaries{0};
+
+    clock.attach();
+    std::thread worker([&]() {
+        Clock::TimePoint next = clock.now() + std::chrono::seconds(1);
+        while (running.load()) {
+            if (clock.waitUntil(next, std::chrono::milliseconds(10))) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                boundaries.fetch_add(1);
+                next += std::chrono::seconds(1);
+            }
+        }
+        clock.detach();
+    });
+
+    for (int second = 1; second <= 5; ++second) {
+        clock.advanceTo(Clock::TimePoint(std::chrono::seconds(1000 + second)));
+        EXPECT_EQ(boundaries.load(), second);
+    }
+    // 时间不倒退
+    clock.advanceTo(Clock::TimePoint(std::chrono::seconds(1002)));
+    EXPECT_EQ(clock.now(), Clock::TimePoint(std::chrono::seconds(1005)));
+
+    running.store(false);
+    clock.interrupt();
+    worker.join();
+}
+
+// 测试 interrupt 立即释放等待线程
+TEST(TEST_Clock, InterruptReleasesWaiters) {
+    SystemClock clock;
+    std::thread waiter([&clock]() {
+        clock.waitUntil(clock.now() + std::chrono::hours(1), std::chrono::hours(1));
+    });
+    auto start = std::chrono::steady_clock::now();
+    clock.interrupt();
+    waiter.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
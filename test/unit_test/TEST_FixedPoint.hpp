@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "FixedPoint.hpp"
+
+// 按 BID64 小系数格式构造 coefficient * 10^exponent
+static Decimal makeBid64(bool negative, uint64_t coefficient, int exponent) {
+    return (negative ? 0x8000000000000000ull : 0) | (static_cast<uint64_t>(exponent + 398) << 53) | coefficient;
+}
+
+// 测试 BID64 解码为定点数量
+TEST(TEST_FixedPoint, DecodeBid64) {
+    ASSERT_EQ(decimalToQuantity(makeBid64(false, 100, 0)), 100 * QUANTITY_SCALE);
+    ASSERT_EQ(decimalToQuantity(makeBid64(false, 15, -1)), 15000);
+    ASSERT_EQ(decimalToQuantity(makeBid64(true, 25, 2)), -2500 * QUANTITY_SCALE);
+    ASSERT_EQ(decimalToQuantity(makeBid64(false, 123456, -6)), 1235);   // 0.123456 四舍五入
+    ASSERT_EQ(decimalToQuantity(0), 0);
+    ASSERT_EQ(decimalToQuantity(UNSET_DECIMAL), UNSET_QUANTITY);
+
+    // 大系数格式：(2^53 + 1) * 10^-4
+    Decimal large = 0x6000000000000000ull | (static_cast<uint64_t>(398 - 4) << 51) | 1;
+    ASSERT_EQ(decimalToQuantity(large), static_cast<Quantity>((1ull << 53) + 1));
+
+    // 超出 int64 范围时饱和
+    ASSERT_EQ(decimalToQuantity(makeBid64(false, 1, 18)), std::numeric_limits<Quantity>::max());
+}
+
+// 测试定点数量编码回 BID64，整数股与 TWS 发送的编码一致
+TEST(TEST_FixedPoint, EncodeBid64) {
+    ASSERT_EQ(quantityToDecimal(100 * QUANTITY_SCALE), makeBid64(false, 100, 0));
+    ASSERT_EQ(quantityToDecimal(15000), makeBid64(false, 15, -1));
+    ASSERT_EQ(quantityToDecimal(-1), makeBid64(true, 1, -4));
+    ASSERT_EQ(quantityToDecimal(0), makeBid64(false, 0, 0));
+    ASSERT_EQ(quantityToDecimal(UNSET_QUANTITY), UNSET_DECIMAL);
+
+    for (Quantity quantity : {Quantity(1), Quantity(12345), Quantity(-987650000), Quantity(4200000000000)}) {
+        ASSERT_EQ(decimalToQuantity(quantityToDecimal(quantity)), quantity);
+    }
+    ASSERT_DOUBLE_EQ(quantityToDouble(15000), 1.5);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "Indicators.hpp"
+
+// 测试 SMA 滚动窗口与未满窗口时的均值
+TEST(TEST_Indicators, SmaRollingWindow) {
+    SmaIndicator sma(3);
+    ASSERT_DOUBLE_EQ(sma.update(1.0), 1.0);
+    ASSERT_DOUBLE_EQ(sma.update(2.0), 1.5);
+    ASSERT_FALSE(sma.ready());
+    ASSERT_DOUBLE_EQ(sma.update(3.0), 2.0);
+    ASSERT_TRUE(sma.ready());
+    ASSERT_DOUBLE_EQ(sma.update(10.0), 5.0);
+}
+
+// 测试 EMA 以 SMA 作为种子后按指数平滑
+TEST(TEST_Indicators, EmaSeededWithSma) {
+    EmaIndicator ema(3);
+    ema.update(1.0);
+    ema.update(2.0);
+    ASSERT_DOUBLE_EQ(ema.update(3.0), 2.0);
+    ASSERT_DOUBLE_EQ(ema.update(6.0), 4.0);
+}
+
+// 测试 Wilder RSI 的中性值、全涨与平滑
+TEST(TEST_Indicators, WilderRsi) {
+    RsiIndicator rsi(2);
+    ASSERT_DOUBLE_EQ(rsi.update(10.0), 50.0);
+    ASSERT_DOUBLE_EQ(rsi.update(11.0), 50.0);
+    ASSERT_DOUBLE_EQ(rsi.update(12.0), 100.0);
+    // avgGain = (1 * 1 + 0) / 2 = 0.5, avgLoss = (0 * 1 + 1) / 2 = 0.5
+    ASSERT_DOUBLE_EQ(rsi.update(11.0), 50.0);
+}
+
+// 测试 MACD 在慢线就绪前为 0，线性上涨时为常数
+TEST(TEST_Indicators, MacdAndSignal) {
+    MacdIndicator macd(2, 4, 2);
+    for (int i = 1; i <= 3; ++i) ASSERT_DOUBLE_EQ(macd.update(i), 0.0);
+    ASSERT_FALSE(macd.ready());
+    for (int i = 4; i <= 200; ++i) macd.update(i);
+    ASSERT_TRUE(macd.ready());
+    ASSERT_NEAR(macd.value(), 1.0, 1e-9);
+    ASSERT_NEAR(macd.signal(), 1.0, 1e-9);
+    ASSERT_NEAR(macd.histogram(), 0.0, 1e-9);
+}
+
+// 测试累计与滚动 VWAP
+TEST(TEST_Indicators, Vwap) {
+    VwapIndicator cumulative;
+    ASSERT_DOUBLE_EQ(cumulative.update(10.0, 0.0), 10.0);
+    cumulative.update(10.0, 1.0);
+    ASSERT_DOUBLE_EQ(cumulative.update(20.0, 3.0), 17.5);
+
+    VwapIndicator rolling(1);
+    rolling.update(10.0, 1.0);
+    ASSERT_DOUBLE_EQ(rolling.update(20.0, 3.0), 20.0);
+}
+
+// 测试动量、布林带与 ATR
+TEST(TEST_Indicators, MomentumBollingerAtr) {
+    MomentumIndicator momentum(2);
+    momentum.update(1.0);
+    ASSERT_DOUBLE_EQ(momentum.update(4.0), 3.0);
+    momentum.update(5.0);
+    ASSERT_TRUE(momentum.ready());
+    ASSERT_DOUBLE_EQ(momentum.update(9.0), 5.0);
+
+    BollingerIndicator bollinger(2, 2.0);
+    bollinger.update(1.0);
+    bollinger.update(3.0);
+    ASSERT_DOUBLE_EQ(bollinger.middle(), 2.0);
+    ASSERT_DOUBLE_EQ(bollinger.upper(), 4.0);
+    ASSERT_DOUBLE_EQ(bollinger.lower(), 0.0);
+
+    AtrIndicator atr(2);
+    ASSERT_DOUBLE_EQ(atr.update(11.0, 9.0, 10.0), 2.0);
+    ASSERT_DOUBLE_EQ(atr.update(14.0, 12.0, 13.0), 3.0);
+    ASSERT_DOUBLE_EQ(atr.update(13.0, 12.0, 12.5), 2.0);
+}
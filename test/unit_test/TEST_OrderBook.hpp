@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "OrderBook.hpp"
+
+// 测试 OrderBook 插入时下移后续档位
+TEST(TEST_OrderBook, InsertShiftsRowsDown) {
+    OrderBook book;
+    ASSERT_TRUE(book.apply(0, 0, 1, 100.0, 10));
+    ASSERT_TRUE(book.apply(1, 0, 1, 99.0, 20));
+    ASSERT_TRUE(book.apply(0, 0, 1, 100.5, 5));
+
+    ASSERT_EQ(book.depth(BookSide::Bid), 3);
+    ASSERT_EQ(book.price(BookSide::Bid, 0), 100.5);
+    ASSERT_EQ(book.price(BookSide::Bid, 1), 100.0);
+    ASSERT_EQ(book.price(BookSide::Bid, 2), 99.0);
+    ASSERT_EQ(book.size(BookSide::Bid, 2), 20);
+    ASSERT_EQ(book.depth(BookSide::Ask), 0);
+}
+
+// 测试 OrderBook 更新与删除
+TEST(TEST_OrderBook, UpdateAndDelete) {
+    OrderBook book;
+    book.apply(0, 0, 0, 101.0, 7);
+    book.apply(1, 0, 0, 101.5, 8);
+    book.apply(2, 0, 0, 102.0, 9);
+
+    ASSERT_TRUE(book.apply(1, 1, 0, 101.25, 3));
+    ASSERT_EQ(book.price(BookSide::Ask, 1), 101.25);
+    ASSERT_EQ(book.size(BookSide::Ask, 1), 3);
+
+    ASSERT_TRUE(book.apply(0, 2, 0, 0.0, 0));
+    ASSERT_EQ(book.depth(BookSide::Ask), 2);
+    ASSERT_EQ(book.bestAsk(), 101.25);
+    ASSERT_EQ(book.price(BookSide::Ask, 1), 102.0);
+}
+
+// 测试 OrderBook 深度上限与非法输入
+TEST(TEST_OrderBook, BoundsAndInvalidInput) {
+    OrderBook book;
+    for (int i = 0; i < OrderBook::MAX_DEPTH + 5; ++i) {
+        book.apply(0, 0, 1, 100.0 + i, 1);
+    }
+    ASSERT_EQ(book.depth(BookSide::Bid), OrderBook::MAX_DEPTH);
+    ASSERT_EQ(book.bestBid(), 100.0 + OrderBook::MAX_DEPTH + 4);
+
+    ASSERT_FALSE(book.apply(OrderBook::MAX_DEPTH, 0, 1, 1.0, 1));
+    ASSERT_FALSE(book.apply(0, 3, 1, 1.0, 1));
+    ASSERT_FALSE(book.apply(0, 0, 2, 1.0, 1));
+
+    book.clear();
+    ASSERT_TRUE(book.empty());
+}
+
+// 测试未设置的数量按 0 计入，不破坏总量
+TEST(TEST_OrderBook, UnsetSizeCountsAsZero) {
+    OrderBook book;
+    ASSERT_TRUE(book.apply(0, 0, 1, 100.0, 5 * QUANTITY_SCALE));
+    ASSERT_TRUE(book.apply(1, 0, 1, 99.9, UNSET_QUANTITY));
+    EXPECT_EQ(book.size(BookSide::Bid, 1), 0);
+    ASSERT_TRUE(book.apply(0, 1, 1, 100.0, UNSET_QUANTITY));
+    EXPECT_EQ(book.volume(BookSide::Bid), 0);
+    ASSERT_TRUE(book.apply(0, 2, 1, 0.0, UNSET_QUANTITY));
+    EXPECT_EQ(book.depth(BookSide::Bid), 1);
+    EXPECT_EQ(book.volume(BookSide::Bid), 0);
+}
+
+// 测试插入、更新、删除和满档挤出后两侧总量始终等于逐档求和
+TEST(TEST_OrderBook, RunningVolumeMatchesLevels) {
+    OrderBook book;
+    auto sum = [&book](BookSide side) {
+        Quantity total = 0;
+        for (int level = 0; level < book.depth(side); ++level) total += book.size(side, level);
+        return total;
+    };
+
+    uint32_t seed = 7;
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int side = (seed >> 8) & 1;
+        int operation = (seed >> 9) % 3;
+        int position = (seed >> 12) % OrderBook::MAX_DEPTH;
+        Quantity size = static_cast<Quantity>((seed >> 20) % 500 + 1);
+        book.apply(position, operation, side, 100.0 + position, size);
+        ASSERT_EQ(book.volume(BookSide::Bid), sum(BookSide::Bid));
+        ASSERT_EQ(book.volume(BookSide::Ask), sum(BookSide::Ask));
+    }
+
+    book.clear();
+    EXPECT_EQ(book.volume(BookSide::Bid), 0);
+    EXPECT_EQ(book.volume(BookSide::Ask), 0);
+}
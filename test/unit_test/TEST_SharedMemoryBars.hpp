@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "FixedPoint.hpp"
+#include "SharedMemoryBars.hpp"
+
+static SharedMemoryBarRecord makeShmRecord(int64_t timestamp, double close) {
+    SharedMemoryBarRecord record{};
+    record.timestamp = timestamp;
+    record.open = record.high = record.low = record.close = close;
+    record.volume = 100 * QUANTITY_SCALE;
+    return record;
+}
+
+// 测试写入端格式化的头部与通道能被读取端识别
+TEST(TEST_SharedMemoryBars, LayoutAndLookup) {
+    std::vector<SharedMemoryChannelSpec> channels{{"SPY", 1}, {"SPY", 60}, {"QQQ", 60}};
+    std::vector<uint64_t> buffer(SharedMemoryBarWriter::requiredSize(channels.size(), 4) / sizeof(uint64_t));
+    SharedMemoryBarWriter writer(buffer.data(), buffer.size() * sizeof(uint64_t), channels, 4);
+    SharedMemoryBarReader reader(buffer.data(), buffer.size() * sizeof(uint64_t));
+
+    ASSERT_EQ(reader.findChannel("SPY", 60), 1);
+    ASSERT_EQ(reader.findChannel("QQQ", 60), 2);
+    ASSERT_EQ(reader.findChannel("QQQ", 1), -1);
+    ASSERT_EQ(reader.listChannels(), channels);
+
+    SharedMemoryBarRecord record;
+    ASSERT_FALSE(reader.latest(0, record));
+    ASSERT_EQ(reader.writeSequence(), 0u);
+
+    // 缓冲区不足或魔数错误时抛出异常
+    ASSERT_THROW(SharedMemoryBarWriter(buffer.data(), 64, channels, 4), std::invalid_argument);
+    std::vector<uint64_t> garbage(buffer.size(), 0);
+    ASSERT_THROW(SharedMemoryBarReader(garbage.data(), garbage.size() * sizeof(uint64_t)), std::runtime_error);
+}
+
+// 测试环形缓冲区只保留最近 N 条记录，并按时间顺序返回
+TEST(TEST_SharedMemoryBars, RingHistory) {
+    std::vector<SharedMemoryChannelSpec> channels{{"SPY", 1}, {"SPY", 5}};
+    std::vector<uint64_t> buffer(SharedMemoryBarWriter::requiredSize(channels.size(), 3) / sizeof(uint64_t));
+    SharedMemoryBarWriter writer(buffer.data(), buffer.size() * sizeof(uint64_t), channels, 3);
+    SharedMemoryBarReader reader(buffer.data(), buffer.size() * sizeof(uint64_t));
+
+    for (int i = 0; i < 5; ++i) {
+        writer.publish(0, makeShmRecord(1000 + i, 10.0 + i));
+    }
+    writer.publish(1, makeShmRecord(1005, 99.0));
+
+    std::vector<SharedMemoryBarRecord> history = reader.history(0, 10);
+    ASSERT_EQ(history.size(), 3u);
+    ASSERT_EQ(history[0].timestamp, 1002);
+    ASSERT_EQ(history[2].timestamp, 1004);
+    ASSERT_DOUBLE_EQ(history[2].close, 14.0);
+    ASSERT_EQ(reader.history(0, 2).front().timestamp, 1003);
+
+    SharedMemoryBarRecord latest;
+    ASSERT_TRUE(reader.latest(1, latest));
+    ASSERT_DOUBLE_EQ(latest.close, 99.0);
+    ASSERT_EQ(latest.volume, 100 * QUANTITY_SCALE);
+    ASSERT_EQ(reader.writeSequence(), 6u);
+    ASSERT_THROW(writer.publish(2, latest), std::out_of_range);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "SpscRing.hpp"
+
+// 测试 SpscRing 容量检查
+TEST(TEST_SpscRing, RejectsNonPowerOfTwoCapacity) {
+    EXPECT_THROW(SpscRing<int>(3), std::invalid_argument);
+    EXPECT_NO_THROW(SpscRing<int>(4));
+}
+
+// 测试 SpscRing 满时丢弃并计数
+TEST(TEST_SpscRing, DropsWhenFull) {
+    SpscRing<int> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.push(i));
+    }
+    ASSERT_FALSE(ring.push(4));
+    ASSERT_EQ(ring.size(), 4u);
+    ASSERT_EQ(ring.dropped(), 1u);
+
+    int value = -1;
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_EQ(value, 0);
+    ASSERT_TRUE(ring.push(5));
+}
+
+// 测试 SpscRing 跨线程顺序
+TEST(TEST_SpscRing, PreservesOrderAcrossThreads) {
+    SpscRing<int> ring(1024);
+    const int total = 200000;
+
+    std::thread producer([&ring]() {
+        for (int i = 0; i < total; ++i) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<int> received;
+    received.reserve(total);
+    while (static_cast<int>(received.size()) < total) {
+        ring.drain([&received](int value) { received.push_back(value); });
+    }
+    producer.join();
+
+    for (int i = 0; i < total; ++i) {
+        ASSERT_EQ(received[i], i);
+    }
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+// 测试任务图按依赖顺序执行，并且可以重复运行
+TEST(TEST_ThreadPool, GraphRunsNodesAfterTheirPredecessors) {
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+        };
+    };
+
+    // 每条链 aggregate -> features -> publish，三条链之间互不依赖
+    for (int chain = 0; chain < 3; ++chain) {
+        TaskGraph::NodeId aggregate = graph.add(record(chain * 10 + 1));
+        TaskGraph::NodeId features = graph.add(record(chain * 10 + 2));
+        TaskGraph::NodeId publish = graph.add(record(chain * 10 + 3));
+        graph.precede(aggregate, features);
+        graph.precede(features, publish);
+    }
+
+    for (int round = 0; round < 100; ++round) {
+        order.clear();
+        graph.run(pool);
+        ASSERT_EQ(order.size(), 9u);
+        std::vector<size_t> position(40);
+        for (size_t i = 0; i < order.size(); ++i) position[order[i]] = i;
+        for (int chain = 0; chain < 3; ++chain) {
+            EXPECT_LT(position[chain * 10 + 1], position[chain * 10 + 2]);
+            EXPECT_LT(position[chain * 10 + 2], position[chain * 10 + 3]);
+        }
+    }
+}
+
+// 测试汇合节点等待所有前驱，异常在全部节点完成后抛出
+TEST(TEST_ThreadPool, JoinWaitsForAllPredecessorsAndRethrows) {
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> done{0};
+    std::atomic<int> seenAtJoin{-1};
+
+    TaskGraph::NodeId join = graph.add([&] { seenAtJoin = done.load(); });
+    for (int i = 0; i < 8; ++i) {
+        TaskGraph::NodeId node = graph.add([&] { done.fetch_add(1); });
+        graph.precede(node, join);
+    }
+    graph.run(pool);
+    EXPECT_EQ(seenAtJoin.load(), 8);
+
+    TaskGraph failing;
+    std::atomic<bool> successorRan{false};
+    TaskGraph::NodeId thrower = failing.add([] { throw std::runtime_error("stage failed"); });
+    TaskGraph::NodeId after = failing.add([&] { successorRan = true; });
+    failing.precede(thrower, after);
+    EXPECT_THROW(failing.run(pool), std::runtime_error);
+    EXPECT_TRUE(successorRan.load());
+}
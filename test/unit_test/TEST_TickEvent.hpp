@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "FeatureKernel.hpp"
+#include "TickEvent.hpp"
+
+// 测试 TickEvent 保持 32 字节并正确打包类型与属性
+TEST(TEST_TickEvent, PacksKindAndAttributes) {
+    EXPECT_EQ(sizeof(TickEvent), 32u);
+    TickEvent event = TickEvent::make(1700000000, 101.5, 3 * QUANTITY_SCALE, TickKind::Trade, TICK_UNREPORTED, 7);
+    EXPECT_EQ(event.kind(), TickKind::Trade);
+    EXPECT_TRUE(event.has(TICK_UNREPORTED));
+    EXPECT_FALSE(event.has(TICK_PAST_LIMIT));
+    EXPECT_EQ(event.sequence, 7u);
+    EXPECT_EQ(event.size, 3 * QUANTITY_SCALE);
+}
+
+// 测试逐笔事件累积成交量与报价次数
+TEST(TEST_TickEvent, AccumulatesFeatures) {
+    const TickEvent events[] = {
+        TickEvent::make(1, 100.00, 0, TickKind::Bid, 0, 0),
+        TickEvent::make(1, 100.02, 0, TickKind::Ask, 0, 0),
+        TickEvent::make(1, 100.01, 2 * QUANTITY_SCALE, TickKind::Trade, 0, 1),
+        TickEvent::make(1, 100.04, 0, TickKind::Ask, 0, 2),
+        TickEvent::make(1, 100.03, 0, TickKind::MidPoint, 0, 3),
+        TickEvent::make(1, 100.02, 1 * QUANTITY_SCALE, TickKind::Trade, 0, 4),
+    };
+    TickFeatures features;
+    accumulateTickFeatures(features, events, sizeof(events) / sizeof(events[0]));
+
+    EXPECT_EQ(features.trades, 2u);
+    EXPECT_EQ(features.quotes, 3u);
+    EXPECT_EQ(features.tradeVolume, 3 * QUANTITY_SCALE);
+}
+
+// 测试未设置的成交量不计入累计成交量
+TEST(TEST_TickEvent, SkipsUnsetTradeSize) {
+    const TickEvent events[] = {
+        TickEvent::make(1, 100.01, UNSET_QUANTITY, TickKind::Trade, 0, 0),
+        TickEvent::make(1, 100.02, 4 * QUANTITY_SCALE, TickKind::Trade, 0, 1),
+    };
+    TickFeatures features;
+    accumulateTickFeatures(features, events, 2);
+    EXPECT_EQ(features.trades, 2u);
+    EXPECT_EQ(features.tradeVolume, 4 * QUANTITY_SCALE);
+}
+
+// 测试 merge 合并计数、reset 清零
+TEST(TEST_TickEvent, MergeAndReset) {
+    TickFeatures bar;
+    TickFeatures second;
+    const TickEvent events[] = {
+        TickEvent::make(1, 50.0, 0, TickKind::Bid, 0, 0),
+        TickEvent::make(1, 50.1, 0, TickKind::Ask, 0, 0),
+    };
+    accumulateTickFeatures(second, events, 2);
+    bar.merge(second);
+    bar.merge(second);
+    EXPECT_EQ(bar.quotes, 4u);
+
+    bar.reset();
+    EXPECT_TRUE(bar.empty());
+}
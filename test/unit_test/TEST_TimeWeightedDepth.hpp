@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "TimeWeightedDepth.hpp"
+
+namespace {
+
+constexpr int64_t SECOND_NS = 1000000000LL;
+
+double sizeSecondsAt(const DepthHistogram& histogram, double price, BookSide side) {
+    const int64_t bucket = histogram.ladder().bucketOf(price);
+    if (histogram.empty() || bucket < histogram.firstBucket() || bucket > histogram.lastBucket()) return 0.0;
+    return side == BookSide::Bid ? histogram.bidSizeSeconds(bucket) : histogram.askSizeSeconds(bucket);
+}
+
+} // namespace
+
+// 测试长时间挂单的价位权重大于频繁闪烁的价位
+TEST(TEST_TimeWeightedDepth, SteadyLevelOutweighsFlicker) {
+    OrderBook book;
+    TimeWeightedDepth depth;
+    const int64_t start = 1000 * SECOND_NS;
+    ASSERT_TRUE(depth.apply(book, 0, 0, 1, 100.00, 10 * QUANTITY_SCALE, start));
+
+    // 99.99 价位在前 0.5 秒内闪烁 500 次
+    for (int i = 0; i < 500; ++i) {
+        int64_t t = start + i * SECOND_NS / 1000;
+        ASSERT_TRUE(depth.apply(book, 1, 0, 1, 99.99, 50 * QUANTITY_SCALE, t));
+        ASSERT_TRUE(depth.apply(book, 1, 2, 1, 0.0, 0, t + SECOND_NS / 2000));
+    }
+
+    depth.flush(start + 10 * SECOND_NS);
+    const DepthHistogram& histogram = depth.histogram();
+    EXPECT_NEAR(histogram.seconds, 10.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 100.00, BookSide::Bid), 100.0, 1e-6);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 99.99, BookSide::Bid), 12.5, 1e-6);
+}
+
+// 测试更新、删除与满档挤出都结算离开盘口的价位
+TEST(TEST_TimeWeightedDepth, AccountsRowsLeavingTheBook) {
+    OrderBook book;
+    // 64 档跨度 64 美元，用 0.5 美元一档的阶梯装下整个盘口
+    const PriceLadder ladder{0.5, 1, 256};
+    TimeWeightedDepth depth(ladder);
+    const int64_t start = 2000 * SECOND_NS;
+    for (int i = 0; i < OrderBook::MAX_DEPTH; ++i) {
+        depth.apply(book, i, 0, 0, 200.0 + i, QUANTITY_SCALE, start);
+    }
+    // 满档插入挤出最后一档 263，更新把 200 改为 199.5
+    depth.apply(book, 0, 0, 0, 199.0, QUANTITY_SCALE, start + SECOND_NS);
+    depth.apply(book, 1, 1, 0, 199.5, 2 * QUANTITY_SCALE, start + 2 * SECOND_NS);
+    depth.apply(book, 0, 2, 0, 0.0, 0, start + 3 * SECOND_NS);
+    depth.flush(start + 4 * SECOND_NS);
+
+    const DepthHistogram& histogram = depth.histogram();
+    EXPECT_NEAR(sizeSecondsAt(histogram, 263.0, BookSide::Ask), 1.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 200.0, BookSide::Ask), 2.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 199.5, BookSide::Ask), 4.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 199.0, BookSide::Ask), 2.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(histogram, 201.0, BookSide::Ask), 4.0, 1e-9);
+
+    // 合并后时长与积分相加，clear 后为空
+    DepthHistogram bar(ladder);
+    bar.merge(histogram);
+    bar.merge(histogram);
+    EXPECT_NEAR(bar.seconds, 8.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(bar, 199.5, BookSide::Ask), 8.0, 1e-9);
+    bar.clear();
+    EXPECT_TRUE(bar.empty());
+}
+
+// 测试未设置的数量不进入时间加权深度
+TEST(TEST_TimeWeightedDepth, UnsetSizeCountsAsZero) {
+    OrderBook book;
+    TimeWeightedDepth depth;
+    const int64_t start = 3000 * SECOND_NS;
+    ASSERT_TRUE(depth.apply(book, 0, 0, 1, 100.00, UNSET_QUANTITY, start));
+    ASSERT_TRUE(depth.apply(book, 1, 0, 1, 99.99, 2 * QUANTITY_SCALE, start));
+    depth.flush(start + SECOND_NS);
+    EXPECT_EQ(book.volume(BookSide::Bid), 2 * QUANTITY_SCALE);
+    EXPECT_NEAR(sizeSecondsAt(depth.histogram(), 100.00, BookSide::Bid), 0.0, 1e-9);
+    EXPECT_NEAR(sizeSecondsAt(depth.histogram(), 99.99, BookSide::Bid), 2.0, 1e-9);
+}
+
+// 测试价格阶梯分桶边界固定，不随 bar 的价格范围变化
+TEST(TEST_TimeWeightedDepth, LadderBucketsAreStable) {
+    PriceLadder ladder{0.01, 5, 8};
+    EXPECT_EQ(ladder.bucketOf(100.00), 2000);
+    EXPECT_EQ(ladder.bucketOf(100.04), 2000);
+    EXPECT_EQ(ladder.bucketOf(100.05), 2001);
+    EXPECT_NEAR(ladder.bucketPrice(2000), 100.02, 1e-9);
+
+    // 两个窗口位置不同的直方图合并后仍按绝对桶号对齐
+    DepthHistogram first(ladder);
+    first.add(BookSide::Bid, ladder.bucketOf(100.00), 1.0);
+    DepthHistogram second(ladder);
+    second.add(BookSide::Bid, ladder.bucketOf(100.12), 2.0);
+    second.add(BookSide::Ask, ladder.bucketOf(100.03), 3.0);
+
+    DepthHistogram bar(ladder);
+    bar.merge(first);
+    bar.merge(second);
+    EXPECT_EQ(bar.firstBucket(), 2000);
+    EXPECT_EQ(bar.lastBucket(), 2002);
+    EXPECT_DOUBLE_EQ(bar.bidSizeSeconds(2000), 1.0);
+    EXPECT_DOUBLE_EQ(bar.askSizeSeconds(2000), 3.0);
+    EXPECT_DOUBLE_EQ(bar.bidSizeSeconds(2002), 2.0);
+
+    // 超出窗口的深度不记到边缘桶，单独累计
+    bar.add(BookSide::Ask, ladder.bucketOf(150.00), 4.0);
+    EXPECT_EQ(bar.lastBucket(), 2002);
+    EXPECT_DOUBLE_EQ(bar.askSizeSeconds(2002), 0.0);
+    EXPECT_DOUBLE_EQ(bar.outsideSizeSeconds, 4.0);
+
+    // clear 之后窗口可以移到新的价位
+    bar.clear();
+    EXPECT_TRUE(bar.empty());
+    bar.add(BookSide::Bid, ladder.bucketOf(150.00), 5.0);
+    EXPECT_EQ(bar.firstBucket(), ladder.bucketOf(150.00));
+    EXPECT_DOUBLE_EQ(bar.bidSizeSeconds(ladder.bucketOf(150.00)), 5.0);
+}
+
+// 测试远离最优价的档位不计入窗口，最优价移出窗口中部时窗口随之移动
+TEST(TEST_TimeWeightedDepth, WindowFollowsTheTouch) {
+    OrderBook book;
+    const PriceLadder ladder{0.01, 1, 8};
+    TimeWeightedDepth depth(ladder);
+    const int64_t start = 4000 * SECOND_NS;
+    ASSERT_TRUE(depth.apply(book, 0, 0, 1, 100.00, QUANTITY_SCALE, start));
+    ASSERT_TRUE(depth.apply(book, 1, 0, 1, 99.00, 2 * QUANTITY_SCALE, start));
+    depth.flush(start + SECOND_NS);
+
+    const DepthHistogram& histogram = depth.histogram();
+    EXPECT_EQ(histogram.firstBucket(), ladder.bucketOf(100.00));
+    EXPECT_EQ(histogram.lastBucket(), ladder.bucketOf(100.00));
+    EXPECT_NEAR(sizeSecondsAt(histogram, 100.00, BookSide::Bid), 1.0, 1e-9);
+    EXPECT_NEAR(histogram.outsideSizeSeconds, 2.0, 1e-9);
+
+    // 101.00 成为最优买价，窗口移到 101.00 附近，100.00 与 99.00 落到窗口外
+    depth.clearHistogram();
+    ASSERT_TRUE(depth.apply(book, 0, 0, 1, 101.00, 3 * QUANTITY_SCALE, start + SECOND_NS));
+    depth.flush(start + 2 * SECOND_NS);
+    EXPECT_EQ(histogram.firstBucket(), ladder.bucketOf(101.00));
+    EXPECT_NEAR(sizeSecondsAt(histogram, 101.00, BookSide::Bid), 3.0, 1e-9);
+    EXPECT_NEAR(histogram.outsideSizeSeconds, 3.0, 1e-9);
+
+    // 窗口外的档位删除后不再累计
+    depth.clearHistogram();
+    ASSERT_TRUE(depth.apply(book, 2, 2, 1, 0.0, 0, start + 2 * SECOND_NS));
+    depth.flush(start + 3 * SECOND_NS);
+    EXPECT_NEAR(histogram.outsideSizeSeconds, 1.0, 1e-9);
+}
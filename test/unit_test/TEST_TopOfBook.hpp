@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "FeatureKernel.hpp"
+#include "TopOfBook.hpp"
+
+// 测试 microprice 与盘口不平衡度
+TEST(TEST_TopOfBook, MicropriceAndImbalance) {
+    TopOfBook quote;
+    EXPECT_FALSE(quote.valid());
+    quote.bid = 100.00;
+    quote.ask = 100.10;
+    quote.bidSize = 300 * QUANTITY_SCALE;
+    quote.askSize = 100 * QUANTITY_SCALE;
+    ASSERT_TRUE(quote.valid());
+    EXPECT_NEAR(quote.spread(), 0.10, 1e-9);
+    // 买方挂单更多，microprice 偏向卖价
+    EXPECT_NEAR(quote.microprice(), 100.075, 1e-9);
+    EXPECT_NEAR(quote.imbalance(), 0.5, 1e-9);
+
+    // 锁价或交叉盘不算有效报价
+    quote.ask = quote.bid;
+    EXPECT_FALSE(quote.valid());
+}
+
+// 测试 Lee-Ready 分类：先用中间价规则，落在中间价时用 tick 规则
+TEST(TEST_TopOfBook, LeeReadySigning) {
+    TopOfBook quote;
+    quote.bid = 10.00;
+    quote.ask = 10.02;
+    TradeSigner signer;
+    EXPECT_EQ(signer.classify(10.02, quote), 1);
+    EXPECT_EQ(signer.classify(10.00, quote), -1);
+    // 中间价成交：上一笔价格变动为下跌，10.01 相对 10.00 为上涨
+    EXPECT_EQ(signer.classify(10.01, quote), 1);
+    // 零 tick 沿用上一次非零价格变动
+    EXPECT_EQ(signer.classify(10.01, quote), 1);
+
+    TopOfBook empty;
+    TradeSigner tickOnly;
+    EXPECT_EQ(tickOnly.classify(5.0, empty), 0);
+    EXPECT_EQ(tickOnly.classify(4.9, empty), -1);
+}
+
+// 测试微观结构特征的采样、合并与重置
+TEST(TEST_TopOfBook, MicrostructureFeatures) {
+    TopOfBook quote;
+    quote.bid = 20.0;
+    quote.ask = 20.2;
+    quote.bidSize = 100 * QUANTITY_SCALE;
+    quote.askSize = 100 * QUANTITY_SCALE;
+
+    MicrostructureFeatures second;
+    second.sampleQuote(quote);
+    second.addTrade(1, 30 * QUANTITY_SCALE);
+    second.addTrade(-1, 10 * QUANTITY_SCALE);
+    second.addTrade(0, 5 * QUANTITY_SCALE);
+
+    MicrostructureFeatures bar;
+    bar.merge(second);
+    bar.merge(second);
+    EXPECT_EQ(bar.quoteSamples, 2u);
+    EXPECT_NEAR(bar.meanSpread(), 0.2, 1e-9);
+    EXPECT_DOUBLE_EQ(bar.meanImbalance(), 0.0);
+    EXPECT_EQ(bar.signedVolume(), 40 * QUANTITY_SCALE);
+    EXPECT_NEAR(bar.orderFlowImbalance(), 0.5, 1e-9);
+
+    bar.reset();
+    EXPECT_TRUE(bar.empty());
+    EXPECT_NEAR(bar.microprice, 20.1, 1e-9);
+}
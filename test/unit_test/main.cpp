@@ -1,4 +1,15 @@
 #include "TEST_TimescaleDB.hpp"
+#include "TEST_SpscRing.hpp"
+#include "TEST_OrderBook.hpp"
+#include "TEST_Indicators.hpp"
+#include "TEST_FixedPoint.hpp"
+#include "TEST_SharedMemoryBars.hpp"
+#include "TEST_Clock.hpp"
+#include "TEST_TickEvent.hpp"
+#include "TEST_TopOfBook.hpp"
+#include "TEST_TimeWeightedDepth.hpp"
+#include "TEST_ThreadPool.hpp"
+#include "TEST_BarSeries.hpp"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -50,6 +50,12 @@ public:
 	bool handleSocketError();
 	int receive( char* buf, size_t sz);
 
+	// Optional observer of every chunk read from the socket, including the
+	// connect handshake. Used to journal the raw stream for offline replay.
+	typedef void (*ReceiveTap)(void* context, const char* data, int size);
+	void setReceiveTap(ReceiveTap tap, void* context);
+	void onReceived(const char* data, int size) const;
+
 public:
 	// callback from socket
 	void onSend();
@@ -66,6 +72,8 @@ private:
     bool m_asyncEConnect;
     EReaderSignal *m_pSignal;
     int m_redirectCount;
+    ReceiveTap m_receiveTap;
+    void* m_receiveTapContext;
 
     static const int REDIRECT_COUNT_MAX = 2;
 
@@ -31,6 +31,8 @@ EClientSocket::EClientSocket(EWrapper* ptr, EReaderSignal* pSignal) : EClient(pt
   m_asyncEConnect = false;
   m_pSignal = pSignal;
   m_redirectCount = 0;
+  m_receiveTap = 0;
+  m_receiveTapContext = 0;
 }
 
 EClientSocket::~EClientSocket()
@@ -376,6 +378,18 @@ void EClientSocket::onError()
   handleSocketError();
 }
 
+void EClientSocket::setReceiveTap(ReceiveTap tap, void* context)
+{
+  m_receiveTapContext = context;
+  m_receiveTap = tap;
+}
+
+void EClientSocket::onReceived(const char* data, int size) const
+{
+  if (m_receiveTap)
+    m_receiveTap(m_receiveTapContext, data, size);
+}
+
 ///////////////////////////////////////////////////////////
 // Register EReader for safe thread shutdown.
 void EClientSocket::registerEReader(EReader* reader)
@@ -193,6 +193,7 @@ void EReader::onReceive() {
   if (nRes <= 0)
     return;
 
+  m_pClientSocket->onReceived(m_buf.data() + nOffset, nRes);
   m_buf.resize(nRes + nOffset);
 }
 